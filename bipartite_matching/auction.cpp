@@ -0,0 +1,282 @@
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+
+enum class Objective { Minimize, Maximize };
+
+class ThreadPool {
+private:
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    std::function<void(size_t)> _task;
+    size_t _generation = 0;
+    size_t _pending = 0;
+    bool _stop = false;
+
+private:
+    void work(size_t thread) {
+        size_t generation = 0;
+        while(true) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stop || _generation != generation; });
+            if(_stop) return;
+
+            generation = _generation;
+            lock.unlock();
+
+            _task(thread);
+
+            lock.lock();
+            if(--_pending == 0) _done.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads) {
+        for(size_t thread = 1; thread < threads; ++thread) {
+            _workers.emplace_back(&ThreadPool::work, this, thread);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for(auto& worker : _workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {
+        return _workers.size() + 1;
+    }
+
+    // Calls body(begin, end, thread) over chunks of [0, count), the caller works as thread 0
+    template<typename Body>
+    void parallel_for(size_t count, Body&& body) {
+        if(_workers.empty() || count < 2) {
+            if(count > 0) body(0, count, 0);
+            return;
+        }
+
+        const size_t chunk = std::max<size_t>(1, std::min<size_t>(256, count / (4 * size())));
+        std::atomic<size_t> next(0);
+        auto run = [&](size_t thread) {
+            for(auto begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+                body(begin, std::min(begin + chunk, count), thread);
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = run;
+            _pending = _workers.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [&] { return _pending == 0; });
+    }
+};
+
+// Bertsekas auction with epsilon scaling over the same cost matrix as hungarian.cpp.
+// Rows bid for columns; a bid raises the column price by the bidder's margin over its
+// second best column plus epsilon. Benefits are the costs scaled by n + 1, so the last
+// phase with epsilon = 1 ends within n scaled units of the optimum, which for integer
+// costs is the optimum itself.
+class Graph {
+private:
+    std::vector<std::vector<int>> costs;
+
+    size_t size;                     // max(rows, columns), the smaller side is padded
+    std::vector<long long> benefit;  // size x size, row major
+    std::vector<long long> prices;
+
+    std::vector<int> pairL;
+    std::vector<int> pairR;
+
+    struct Bid {
+        int column;
+        long long price;
+    };
+
+private:
+    Bid bid(int row, long long epsilon) const {
+        const auto* values = benefit.data() + row * size;
+
+        auto best = std::numeric_limits<long long>::min();
+        auto second = std::numeric_limits<long long>::min();
+        int column = 0;
+        for(size_t j = 0; j < size; ++j) {
+            const auto value = values[j] - prices[j];
+            if(value > best) {
+                second = best;
+                best = value;
+                column = j;
+            } else if(value > second) {
+                second = value;
+            }
+        }
+
+        if(size == 1) second = best;
+        return { column, prices[column] + best - second + epsilon };
+    }
+
+    void assign(int row, const Bid& bid, std::vector<int>& unassigned) {
+        const auto owner = pairR[bid.column];
+        if(owner != -1) {
+            pairL[owner] = -1;
+            unassigned.push_back(owner);
+        }
+
+        prices[bid.column] = bid.price;
+        pairL[row] = bid.column;
+        pairR[bid.column] = row;
+    }
+
+    // One bid at a time, each bid sees the prices of all the previous ones
+    void gauss_seidel(long long epsilon, std::vector<int>& unassigned) {
+        while(!unassigned.empty()) {
+            const auto row = unassigned.back();
+            unassigned.pop_back();
+            assign(row, bid(row, epsilon), unassigned);
+        }
+    }
+
+    // All unassigned rows bid against the same prices in parallel, then every column
+    // goes to its highest bidder. Rounds too small to split run on the calling thread.
+    void jacobi(long long epsilon, std::vector<int>& unassigned, ThreadPool& pool) {
+        std::vector<Bid> bids;
+        std::vector<int> winner(size, -1);
+        std::vector<int> columns;
+        std::vector<int> next;
+
+        while(!unassigned.empty()) {
+            bids.resize(unassigned.size());
+
+            auto work = [&](size_t begin, size_t end, size_t) {
+                for(auto i = begin; i < end; ++i) {
+                    bids[i] = bid(unassigned[i], epsilon);
+                }
+            };
+
+            if(unassigned.size() < 16 * pool.size()) work(0, unassigned.size(), 0);
+            else pool.parallel_for(unassigned.size(), work);
+
+            columns.clear();
+            for(size_t i = 0; i < unassigned.size(); ++i) {
+                auto& best = winner[ bids[i].column ];
+                if(best == -1) columns.push_back(bids[i].column);
+                if(best == -1 || bids[i].price > bids[best].price) best = i;
+            }
+
+            next.clear();
+            for(size_t i = 0; i < unassigned.size(); ++i) {
+                if(winner[ bids[i].column ] != static_cast<int>(i)) next.push_back(unassigned[i]);
+            }
+            for(const auto column : columns) {
+                const auto i = winner[column];
+                assign(unassigned[i], bids[i], next);
+                winner[column] = -1;
+            }
+            unassigned.swap(next);
+        }
+    }
+
+public:
+    explicit Graph(const std::vector<std::vector<int>>& costs) : costs(costs) {
+        size = std::max(costs.size(), costs[0].size());
+    }
+
+    // threads == 1 bids Gauss-Seidel style, more threads bid Jacobi style.
+    // Returns the total cost of the assignment, rows matched to padding are unassigned.
+    long long solve(Objective objective = Objective::Maximize, size_t threads = 1) {
+        const auto n = costs.size();
+        const auto m = costs[0].size();
+        const long long sign = objective == Objective::Maximize ? 1 : -1;
+        const auto scale = static_cast<long long>(size) + 1;
+
+        benefit.assign(size * size, 0);
+        long long largest = 0;
+        for(size_t i = 0; i < n; ++i) {
+            for(size_t j = 0; j < m; ++j) {
+                benefit[i * size + j] = sign * costs[i][j] * scale;
+                largest = std::max(largest, std::abs(benefit[i * size + j]));
+            }
+        }
+
+        prices.assign(size, 0);
+        std::vector<int> unassigned;
+
+        // Started once, every Jacobi round of every phase reuses the workers
+        ThreadPool pool(threads);
+
+        auto epsilon = std::max<long long>(1, largest / 2);
+        while(true) {
+            pairL.assign(size, -1);
+            pairR.assign(size, -1);
+            unassigned.resize(size);
+            for(size_t i = 0; i < size; ++i) {
+                unassigned[i] = size - 1 - i;
+            }
+
+            if(threads > 1) jacobi(epsilon, unassigned, pool);
+            else gauss_seidel(epsilon, unassigned);
+
+            if(epsilon == 1) break;
+            epsilon = std::max<long long>(1, epsilon / 8);
+        }
+
+        long long total_sum = 0;
+        for(size_t i = 0; i < n; ++i) {
+            if(pairL[i] < static_cast<int>(m)) total_sum += costs[i][ pairL[i] ];
+        }
+        return total_sum;
+    }
+
+    void print() const {
+        for(size_t i = 0; i < costs.size(); ++i) {
+            if(i >= pairL.size() || pairL[i] >= static_cast<int>(costs[i].size())) {
+                std::cout << "l: " << i << ", r: -1" << std::endl;
+                continue;
+            }
+            std::cout << "l: " << i << ", r: " << pairL[i] << ", cost: " << costs[i][ pairL[i] ] << std::endl;
+        }
+    }
+};
+
+int main() {
+    std::vector<std::vector<int>> costs = {
+        {  4, 10, 10, 10,  2,  9,  3 },
+        {  6,  8,  5, 12,  9,  7,  2 },
+        { 11,  9,  6,  7,  9,  5, 15 },
+        {  3,  9,  6,  7,  5,  6,  3 },
+        {  2,  6,  5,  3,  2,  4,  2 },
+        { 10,  8, 11,  4, 11,  2, 11 },
+        {  3,  4,  5,  4,  3,  6,  8 }
+    };
+
+    Graph graph(costs);
+    std::cout << "Auction max: " << graph.solve(Objective::Maximize) << std::endl;
+    std::cout << "Auction min: " << graph.solve(Objective::Minimize, 4) << std::endl << std::endl;
+
+    graph.print();
+    return 0;
+}
@@ -1,68 +1,166 @@
 #include <iostream>
+#include <limits>
+#include <algorithm>
 #include <queue>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <cstdint>
 
 class Graph {
 private:
-    std::vector<std::vector<int>> men_preferences;
-    std::vector<std::vector<int>> women_rank;
+    static constexpr int unacceptable = std::numeric_limits<int>::max();
+
+    // Preference lists of the men, flat: man i ranks [men_offsets[i], men_offsets[i + 1])
+    std::vector<size_t> men_offsets;
+    std::vector<int> men_preferences;
+    // Rank the woman of every men_preferences entry gives to its man, unacceptable if she
+    // doesn't list him. Lists don't have to be complete.
+    std::vector<int> women_rank;
 
     std::vector<int> men_pairs;
     std::vector<int> women_pairs;
 
 public:
     Graph(std::vector<std::vector<int>>&& mpreferences, std::vector<std::vector<int>>&& wpreferences) {
-        men_preferences = std::move(mpreferences);
+        const auto men = mpreferences.size();
+        const auto women = wpreferences.size();
+
+        men_offsets.assign(men + 1, 0);
+        for(size_t i = 0; i < men; ++i) {
+            men_offsets[i + 1] = men_offsets[i] + mpreferences[i].size();
+        }
+
+        men_preferences.resize(men_offsets[men]);
+        for(size_t i = 0; i < men; ++i) {
+            std::copy(mpreferences[i].begin(), mpreferences[i].end(), men_preferences.begin() + men_offsets[i]);
+        }
+        mpreferences.clear();
+
+        // Entries grouped by woman, each one with its man
+        std::vector<size_t> women_offsets(women + 1, 0);
+        for(const auto woman : men_preferences) {
+            ++women_offsets[woman + 1];
+        }
+        for(size_t i = 0; i < women; ++i) women_offsets[i + 1] += women_offsets[i];
 
-        men_pairs.assign(men_preferences.size(), -1);
-        women_pairs.assign(wpreferences.size(), -1);
+        std::vector<std::pair<size_t, int>> proposals(men_preferences.size());
+        std::vector<size_t> position(women_offsets.begin(), women_offsets.end() - 1);
+        for(size_t i = 0; i < men; ++i) {
+            for(auto entry = men_offsets[i]; entry < men_offsets[i + 1]; ++entry) {
+                proposals[ position[ men_preferences[entry] ]++ ] = { entry, i };
+            }
+        }
 
-        women_rank.assign(wpreferences.size(), std::vector<int>(men_preferences.size()));
-        for(size_t i = 0; i < wpreferences.size(); ++i) {
+        women_rank.assign(men_preferences.size(), unacceptable);
+        std::vector<int> rank_of(men, unacceptable);
+        for(size_t i = 0; i < women; ++i) {
             for(size_t j = 0, rank = 0; j < wpreferences[i].size(); ++j) {
-                women_rank[i][ wpreferences[i][j] ] = rank++;
+                rank_of[ wpreferences[i][j] ] = rank++;
+            }
+            for(auto k = women_offsets[i]; k < women_offsets[i + 1]; ++k) {
+                women_rank[ proposals[k].first ] = rank_of[ proposals[k].second ];
+            }
+            for(const auto man : wpreferences[i]) {
+                rank_of[man] = unacceptable;
             }
         }
+
+        men_pairs.assign(men, -1);
+        women_pairs.assign(women, -1);
     }
 
     void solve() {
+        std::fill(men_pairs.begin(), men_pairs.end(), -1);
+        std::fill(women_pairs.begin(), women_pairs.end(), -1);
+        std::vector<int> women_pairs_rank(women_pairs.size(), unacceptable);
+
         std::queue<size_t> free_men;
-        for(size_t i = 0; i < men_preferences.size(); ++i) {
+        for(size_t i = 0; i < men_pairs.size(); ++i) {
             free_men.push(i);
         }
 
-        std::vector<int> next_candidate_idx(men_preferences.size(), 0);
+        std::vector<size_t> next_candidate_idx(men_offsets.begin(), men_offsets.end() - 1);
         while(!free_men.empty()) {
             const auto man_idx = free_men.front();
             free_men.pop();
 
-            while(true) {
-                const auto woman_idx = men_preferences[man_idx][ next_candidate_idx[ man_idx ]++ ];
-                const auto current_man_idx = women_pairs[woman_idx];
-
-                std::cout << "man_idx: " << man_idx << ", woman_idx: " << woman_idx << ", current_man_idx: " << current_man_idx << std::endl;
+            while(next_candidate_idx[man_idx] < men_offsets[man_idx + 1]) {
+                const auto entry = next_candidate_idx[man_idx]++;
+                const auto woman_idx = men_preferences[entry];
+                if(women_rank[entry] >= women_pairs_rank[woman_idx]) continue;   // she keeps her man
 
-                if(current_man_idx == -1) {  // woman is free
-                    std::cout << "woman was free" << std::endl;
-
-                    men_pairs[man_idx] = woman_idx;
-                    women_pairs[woman_idx] = man_idx;
-                    break;
-                }
-
-                if(women_rank[woman_idx][man_idx] < women_rank[woman_idx][current_man_idx]) {
-                    std::cout << "win a woman" << std::endl;
-
-                    men_pairs[man_idx] = woman_idx;
-                    women_pairs[woman_idx] = man_idx;
+                const auto current_man_idx = women_pairs[woman_idx];
+                men_pairs[man_idx] = woman_idx;
+                women_pairs[woman_idx] = man_idx;
+                women_pairs_rank[woman_idx] = women_rank[entry];
 
+                if(current_man_idx != -1) {
                     men_pairs[current_man_idx] = -1;
                     free_men.push(current_man_idx);
-                    break;
                 }
+                break;
+            }
+        }
+    }
 
-                std::cout << "nothing happened" << std::endl;
+    // McVitie-Wilson on `threads` threads: a thread takes a free man and lets him propose
+    // until a woman holds him, then goes on with the man he displaced. A woman holds the
+    // key rank << 32 | man, which only a smaller key replaces by CAS, so every proposal
+    // is atomic and the result is the same men-optimal matching as solve().
+    // threads == 0 picks std::thread::hardware_concurrency()
+    void solve_parallel(size_t threads = 0) {
+        if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const auto men = men_pairs.size();
+        const auto women = women_pairs.size();
+        const auto free = std::numeric_limits<std::uint64_t>::max();
+        const auto none = std::numeric_limits<size_t>::max();
+
+        std::vector<std::atomic<std::uint64_t>> held(women);
+        for(auto& key : held) {
+            key.store(free, std::memory_order_relaxed);
+        }
+
+        // A free man belongs to one thread, and the CAS that displaces him publishes his position
+        std::vector<size_t> next_candidate_idx(men_offsets.begin(), men_offsets.end() - 1);
+        std::atomic<size_t> next_man(0);
+
+        auto work = [&]() {
+            for(auto man = next_man.fetch_add(1); man < men; man = next_man.fetch_add(1)) {
+                for(auto proposer = man; proposer != none; ) {
+                    auto displaced = none;
+                    while(next_candidate_idx[proposer] < men_offsets[proposer + 1]) {
+                        const auto entry = next_candidate_idx[proposer]++;
+                        if(women_rank[entry] == unacceptable) continue;
+
+                        const auto key = static_cast<std::uint64_t>(women_rank[entry]) << 32 | proposer;
+                        auto& slot = held[ men_preferences[entry] ];
+                        auto current = slot.load(std::memory_order_acquire);
+                        while(key < current && !slot.compare_exchange_weak(current, key, std::memory_order_acq_rel, std::memory_order_acquire)) {}
+
+                        if(key < current) {
+                            if(current != free) displaced = current & 0xffffffffu;
+                            break;
+                        }
+                    }
+                    proposer = displaced;
+                }
             }
+        };
+
+        std::vector<std::thread> workers;
+        for(size_t thread = 1; thread < std::min(threads, std::max<size_t>(men, 1)); ++thread) {
+            workers.emplace_back(work);
+        }
+        work();
+        for(auto& worker : workers) worker.join();
+
+        std::fill(men_pairs.begin(), men_pairs.end(), -1);
+        for(size_t i = 0; i < women; ++i) {
+            const auto key = held[i].load(std::memory_order_relaxed);
+            women_pairs[i] = key == free ? -1 : static_cast<int>(key & 0xffffffffu);
+            if(key != free) men_pairs[ women_pairs[i] ] = i;
         }
     }
 
@@ -91,5 +189,9 @@ int main() {
     graph.solve();
     graph.print();
 
+    graph.solve_parallel(4);
+    std::cout << std::endl << "Parallel:" << std::endl;
+    graph.print();
+
     return 0;
 }
\ No newline at end of file
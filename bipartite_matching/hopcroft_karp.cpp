@@ -1,16 +1,102 @@
 #include <iostream>
 #include <queue>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 class Graph {
 private:
     std::vector<int> pairL;
     std::vector<int> pairR;
 
-    std::vector<std::vector<int>> adjacency_list;
+    // CSR adjacency of both sides: neighbours of L vertex u are
+    // adjacencyL[offsetsL[u] .. offsetsL[u + 1]), and the same for R
+    std::vector<size_t> offsetsL;
+    std::vector<int> adjacencyL;
+    std::vector<size_t> offsetsR;
+    std::vector<int> adjacencyR;
+
+    std::vector<int> levels;
+    std::vector<size_t> current;    // current-edge pointers of the L vertices
 
 private:
-    bool bfs(std::vector<int>& levels) {
+    // Karp-Sipser: a vertex with a single free neighbour can always be matched to it
+    // without losing optimality; when there is none, match an arbitrary edge
+    size_t greedy_matching() {
+        const int n = pairL.size();
+        const int m = pairR.size();
+
+        // Free neighbours of every vertex, R vertices are numbered from n
+        std::vector<size_t> degree(n + m);
+        std::vector<int> ones;
+        for(int u = 0; u < n; ++u) {
+            degree[u] = offsetsL[u + 1] - offsetsL[u];
+            if(degree[u] == 1) ones.push_back(u);
+        }
+        for(int v = 0; v < m; ++v) {
+            degree[n + v] = offsetsR[v + 1] - offsetsR[v];
+            if(degree[n + v] == 1) ones.push_back(n + v);
+        }
+
+        auto match = [&](int u, int v) {
+            pairL[u] = v;
+            pairR[v] = u;
+            for(auto it = offsetsL[u]; it < offsetsL[u + 1]; ++it) {
+                const auto to = adjacencyL[it];
+                if(pairR[to] == -1 && --degree[n + to] == 1) ones.push_back(n + to);
+            }
+            for(auto it = offsetsR[v]; it < offsetsR[v + 1]; ++it) {
+                const auto to = adjacencyR[it];
+                if(pairL[to] == -1 && --degree[to] == 1) ones.push_back(to);
+            }
+        };
+
+        size_t counter = 0;
+        int next = 0;
+        while(true) {
+            if(!ones.empty()) {
+                const auto vertex = ones.back();
+                ones.pop_back();
+
+                if(vertex < n) {
+                    if(pairL[vertex] != -1) continue;
+                    for(auto it = offsetsL[vertex]; it < offsetsL[vertex + 1]; ++it) {
+                        if(pairR[ adjacencyL[it] ] == -1) {
+                            match(vertex, adjacencyL[it]);
+                            ++counter;
+                            break;
+                        }
+                    }
+                } else {
+                    const auto v = vertex - n;
+                    if(pairR[v] != -1) continue;
+                    for(auto it = offsetsR[v]; it < offsetsR[v + 1]; ++it) {
+                        if(pairL[ adjacencyR[it] ] == -1) {
+                            match(adjacencyR[it], v);
+                            ++counter;
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            while(next < n && (pairL[next] != -1 || degree[next] == 0)) ++next;
+            if(next == n) break;
+
+            for(auto it = offsetsL[next]; it < offsetsL[next + 1]; ++it) {
+                if(pairR[ adjacencyL[it] ] == -1) {
+                    match(next, adjacencyL[it]);
+                    ++counter;
+                    break;
+                }
+            }
+        }
+        return counter;
+    }
+
+    bool bfs() {
         std::queue<int> queue;
         for(int i = 0; i < pairL.size(); ++i) {
             if(pairL[i] == -1) {
@@ -28,7 +114,8 @@ private:
                 const auto from = queue.front();
                 queue.pop();
 
-                for(const auto to : adjacency_list[from]) {
+                for(auto it = offsetsL[from]; it < offsetsL[from + 1]; ++it) {
+                    const auto to = adjacencyL[it];
                     if(pairR[to] == -1) {
                         finished = true;
                         continue;
@@ -44,16 +131,158 @@ private:
         return finished;
     }
 
-    bool dfs(int from, const std::vector<int>& levels, std::vector<bool>& visited) {
-        if(visited[from]) return false;
-        visited[from] = true;
+    // Augmenting path from a free L vertex along the levels, with an explicit stack of L
+    // vertices; the edge each of them takes is the one under its current pointer.
+    // Vertices that lead nowhere leave the level graph for the rest of the phase.
+    bool dfs(int start, std::vector<int>& stack) {
+        stack.assign(1, start);
+
+        while(!stack.empty()) {
+            const auto from = stack.back();
+            auto& it = current[from];
+
+            for(; it < offsetsL[from + 1]; ++it) {
+                const auto to = adjacencyL[it];
+                if(pairR[to] == -1 || levels[ pairR[to] ] == levels[from] + 1) break;
+            }
+
+            if(it == offsetsL[from + 1]) {
+                levels[from] = -1;
+                stack.pop_back();
+                if(!stack.empty()) ++current[ stack.back() ];
+                continue;
+            }
+
+            const auto to = adjacencyL[it];
+            if(pairR[to] != -1) {
+                stack.push_back(pairR[to]);
+                continue;
+            }
+
+            for(auto i = stack.size(); i-- > 0; ) {
+                const auto u = stack[i];
+                const auto v = adjacencyL[ current[u] ];
+                pairL[u] = v;
+                pairR[v] = u;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Augmentations of one phase on the levels of the last bfs
+    size_t augment_phase() {
+        current.assign(offsetsL.begin(), offsetsL.end() - 1);
+
+        size_t counter = 0;
+        std::vector<int> stack;
+        for(int u = 0; u < pairL.size(); ++u) {
+            if((pairL[u] == -1) && dfs(u, stack)) {
+                ++counter;
+            }
+        }
+        return counter;
+    }
+
+    template <typename Body>
+    static void parallel(size_t threads, Body body) {
+        std::vector<std::thread> workers;
+        for(size_t thread = 1; thread < threads; ++thread) {
+            workers.emplace_back(body, thread);
+        }
+        body(0);
+        for(auto& worker : workers) worker.join();
+    }
+
+    // Level-synchronous BFS, the threads split every level of the frontier and claim the
+    // L vertices of the next one with a CAS on their level
+    bool parallel_bfs(size_t threads, const std::vector<std::atomic<int>>& sharedR, std::vector<std::atomic<int>>& sharedLevels) {
+        std::vector<int> frontier;
+        const int n = pairL.size();
+        for(int u = 0; u < n; ++u) {
+            sharedLevels[u].store(pairL[u] == -1 ? 0 : -1, std::memory_order_relaxed);
+            if(pairL[u] == -1) frontier.push_back(u);
+        }
+
+        std::atomic<bool> finished(false);
+        std::vector<std::vector<int>> next(threads);
+
+        for(int level = 0; !frontier.empty() && !finished; ++level) {
+            const auto workers = std::min(threads, 1 + frontier.size() / 1024);
+            parallel(workers, [&](size_t thread) {
+                next[thread].clear();
+                const auto first = frontier.size() * thread / workers;
+                const auto last = frontier.size() * (thread + 1) / workers;
+
+                for(auto i = first; i < last; ++i) {
+                    const auto from = frontier[i];
+                    for(auto it = offsetsL[from]; it < offsetsL[from + 1]; ++it) {
+                        const auto owner = sharedR[ adjacencyL[it] ].load(std::memory_order_relaxed);
+                        if(owner == -1) {
+                            finished.store(true, std::memory_order_relaxed);
+                            continue;
+                        }
+
+                        int unvisited = -1;
+                        if(sharedLevels[owner].compare_exchange_strong(unvisited, level + 1, std::memory_order_relaxed)) {
+                            next[thread].push_back(owner);
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for(size_t thread = 0; thread < workers; ++thread) {
+                frontier.insert(frontier.end(), next[thread].begin(), next[thread].end());
+            }
+        }
+        return finished;
+    }
+
+    // dfs for many free vertices at once: an L vertex is claimed before it is entered and
+    // stays claimed for the phase, a free R vertex is claimed by a CAS on its pairR entry,
+    // so the augmenting paths are vertex disjoint. A path can fail on a vertex another
+    // thread holds, which the serial dfs would have explored.
+    bool parallel_dfs(int start, std::vector<int>& stack, std::vector<std::atomic<int>>& sharedR,
+                      const std::vector<std::atomic<int>>& sharedLevels, std::vector<std::atomic<char>>& claimed) {
+        stack.assign(1, start);
+
+        while(!stack.empty()) {
+            const auto from = stack.back();
+            const auto level = sharedLevels[from].load(std::memory_order_relaxed);
+
+            int next = -1;
+            for(auto& it = current[from]; it < offsetsL[from + 1]; ++it) {
+                const auto to = adjacencyL[it];
+                auto owner = sharedR[to].load();
+
+                if(owner == -1) {
+                    if(!sharedR[to].compare_exchange_strong(owner, from)) continue;
+
+                    pairL[from] = to;
+                    for(auto i = stack.size() - 1; i-- > 0; ) {
+                        const auto u = stack[i];
+                        const auto v = adjacencyL[ current[u] ];
+                        pairL[u] = v;
+                        sharedR[v].store(u);
+                    }
+                    return true;
+                }
+
+                char free = 0;
+                if(sharedLevels[owner].load(std::memory_order_relaxed) == level + 1 && claimed[owner].compare_exchange_strong(free, 1)) {
+                    next = owner;
+                    break;
+                }
+            }
 
-        for(const auto to : adjacency_list[from]) {
-            if((pairR[to] == -1) || ((levels[ pairR[to] ] == levels[from] + 1) && dfs(pairR[to], levels, visited))) {
-                pairL[from] = to;
-                pairR[to] = from;
-                return true;
+            if(next != -1) {
+                stack.push_back(next);
+                continue;
             }
+
+            stack.pop_back();
+            if(!stack.empty()) ++current[ stack.back() ];
         }
         return false;
     }
@@ -63,23 +292,88 @@ public:
         pairL.assign(n, -1);
         pairR.assign(m, -1);
 
-        adjacency_list.assign(n, {});
+        offsetsL.assign(n + 1, 0);
+        offsetsR.assign(m + 1, 0);
+        for(const auto& edge : edges) {
+            ++offsetsL[ edge[0] ];
+            ++offsetsR[ edge[1] ];
+        }
+        for(size_t u = 0; u < n; ++u) offsetsL[u + 1] += offsetsL[u];
+        for(size_t v = 0; v < m; ++v) offsetsR[v + 1] += offsetsR[v];
+
+        adjacencyL.resize(edges.size());
+        adjacencyR.resize(edges.size());
+        std::vector<size_t> positionL(offsetsL.begin(), offsetsL.end() - 1);
+        std::vector<size_t> positionR(offsetsR.begin(), offsetsR.end() - 1);
         for(const auto& edge : edges) {
-            adjacency_list[ edge[0] - 1 ].push_back( edge[1] - 1 );
+            adjacencyL[ positionL[ edge[0] - 1 ]++ ] = edge[1] - 1;
+            adjacencyR[ positionR[ edge[1] - 1 ]++ ] = edge[0] - 1;
         }
+
+        levels.resize(n);
+        current.resize(n);
     }
 
     size_t solve() {
-        std::vector<int> levels(pairL.size());
+        size_t counter = greedy_matching();
+        while(bfs()) {
+            counter += augment_phase();
+        }
+        return counter;
+    }
 
-        size_t counter = 0;
-        while(bfs(levels)) {
-            std::vector<bool> visited(pairL.size(), false); 
-            for(int u = 0; u < pairL.size(); ++u) {
-                if((pairL[u] == -1) && dfs(u, levels, visited)) {
-                    ++counter;
+    // Same matching size as solve(), the phases run on `threads` threads.
+    // threads == 0 picks std::thread::hardware_concurrency()
+    size_t solve_parallel(size_t threads = 0) {
+        if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const int n = pairL.size();
+        const int m = pairR.size();
+        size_t counter = greedy_matching();
+
+        std::vector<std::atomic<int>> sharedR(m);
+        std::vector<std::atomic<int>> sharedLevels(n);
+        std::vector<std::atomic<char>> claimed(n);
+        for(int v = 0; v < m; ++v) {
+            sharedR[v].store(pairR[v], std::memory_order_relaxed);
+        }
+
+        std::vector<int> free;
+        while(parallel_bfs(threads, sharedR, sharedLevels)) {
+            current.assign(offsetsL.begin(), offsetsL.end() - 1);
+            free.clear();
+            for(int u = 0; u < n; ++u) {
+                claimed[u].store(pairL[u] == -1, std::memory_order_relaxed);
+                if(pairL[u] == -1) free.push_back(u);
+            }
+
+            std::atomic<size_t> next(0);
+            std::atomic<size_t> augmented(0);
+            parallel(std::min(threads, free.size()), [&](size_t) {
+                std::vector<int> stack;
+                size_t local = 0;
+                for(auto i = next.fetch_add(1); i < free.size(); i = next.fetch_add(1)) {
+                    if(parallel_dfs(free[i], stack, sharedR, sharedLevels, claimed)) ++local;
+                }
+                augmented += local;
+            });
+
+            // Claims can block every path of a phase, a serial phase always makes progress
+            if(augmented == 0) {
+                for(int v = 0; v < m; ++v) {
+                    pairR[v] = sharedR[v].load(std::memory_order_relaxed);
+                }
+                bfs();
+                augmented = augment_phase();
+                for(int v = 0; v < m; ++v) {
+                    sharedR[v].store(pairR[v], std::memory_order_relaxed);
                 }
             }
+            counter += augmented;
+        }
+
+        for(int v = 0; v < m; ++v) {
+            pairR[v] = sharedR[v].load(std::memory_order_relaxed);
         }
         return counter;
     }
@@ -124,5 +418,8 @@ int main() {
     graph.solve();
     graph.print();
 
+    Graph parallel(7, 8, edges);
+    std::cout << std::endl << "Parallel matching size: " << parallel.solve_parallel(4) << std::endl;
+
     return 0;
-}
\ No newline at end of file
+}
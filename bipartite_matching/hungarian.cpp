@@ -1,11 +1,349 @@
 #include <iostream>
 #include <limits>
+#include <algorithm>
 #include <queue>
 #include <vector>
+#include <new>
+#include <optional>
+#include <thread>
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+enum class Objective { Minimize, Maximize };
+
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment))); }
+    void deallocate(T* pointer, size_t) { ::operator delete(pointer, std::align_val_t(Alignment)); }
+
+    bool operator==(const AlignedAllocator&) const { return true; }
+    bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+// Column kernels of the Hungarian method. Each one walks a cost row, which starts on a
+// 32 byte boundary, against the column potentials. sign is 0 to use the costs as they
+// are and -1 to negate them, visited holds 0 or -1 per column.
+namespace kernels {
+    struct Table {
+        // Lowers slack[j] to the reduced weight from row `from` for the unvisited columns
+        // and returns the unvisited column with the smallest slack, count if there is none
+        size_t (*relax)(const int* costs, int sign, int potential, int from, const int* potentials,
+                        int* slack, int* slackL, const int* visited, size_t count);
+        // Raises the potentials of the visited columns by delta, lowers the slack of the others
+        // that some row of the tree reaches
+        void (*shift)(int delta, int* potentials, int* slack, const int* visited, size_t count);
+        // First column from `start` on with potential + potentials[j] == costs[j], count if none
+        size_t (*tight)(const int* costs, int potential, const int* potentials, size_t start, size_t count);
+        // Smallest non-zero potential + potentials[j] - costs[j] over the unvisited columns
+        int (*reduced_min)(const int* costs, int potential, const int* potentials, const int* visited, size_t count);
+    };
+
+    namespace scalar {
+        inline size_t relax(const int* costs, int sign, int potential, int from, const int* potentials,
+                            int* slack, int* slackL, const int* visited, size_t count) {
+            auto best = std::numeric_limits<int>::max();
+            auto next = count;
+            for(size_t j = 0; j < count; ++j) {
+                if(visited[j]) continue;
+
+                const auto reduced = potential + potentials[j] - ((costs[j] ^ sign) - sign);
+                if(reduced < slack[j]) {
+                    slack[j] = reduced;
+                    slackL[j] = from;
+                }
+                if(slack[j] < best) {
+                    best = slack[j];
+                    next = j;
+                }
+            }
+            return next;
+        }
+
+        inline void shift(int delta, int* potentials, int* slack, const int* visited, size_t count) {
+            for(size_t j = 0; j < count; ++j) {
+                if(visited[j]) potentials[j] += delta;
+                else if(slack[j] != std::numeric_limits<int>::max()) slack[j] -= delta;
+            }
+        }
+
+        inline size_t tight(const int* costs, int potential, const int* potentials, size_t start, size_t count) {
+            for(auto j = start; j < count; ++j) {
+                if(potential + potentials[j] == costs[j]) return j;
+            }
+            return count;
+        }
+
+        inline int reduced_min(const int* costs, int potential, const int* potentials, const int* visited, size_t count) {
+            auto best = std::numeric_limits<int>::max();
+            for(size_t j = 0; j < count; ++j) {
+                const auto reduced = potential + potentials[j] - costs[j];
+                if(!visited[j] && reduced != 0) best = std::min(best, reduced);
+            }
+            return best;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    namespace avx2 {
+        __attribute__((target("avx2")))
+        inline __m256i load(const int* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+
+        __attribute__((target("avx2")))
+        inline void store(int* values, __m256i vector) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), vector); }
+
+        __attribute__((target("avx2")))
+        inline __m256i load_costs(const int* costs) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(costs)); }
+
+        __attribute__((target("avx2")))
+        size_t relax(const int* costs, int sign, int potential, int from, const int* potentials,
+                     int* slack, int* slackL, const int* visited, size_t count) {
+            const auto signs = _mm256_set1_epi32(sign);
+            const auto potentialL = _mm256_set1_epi32(potential);
+            const auto row = _mm256_set1_epi32(from);
+            const auto infinity = _mm256_set1_epi32(std::numeric_limits<int>::max());
+            const auto step = _mm256_set1_epi32(8);
+
+            auto best = infinity;
+            auto bestIndex = _mm256_setzero_si256();
+            auto index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+            size_t j = 0;
+            for(; j + 8 <= count; j += 8) {
+                const auto weight = _mm256_sub_epi32(_mm256_xor_si256(load_costs(costs + j), signs), signs);
+                const auto reduced = _mm256_sub_epi32(_mm256_add_epi32(potentialL, load(potentials + j)), weight);
+                const auto done = load(visited + j);
+
+                auto current = load(slack + j);
+                const auto lower = _mm256_andnot_si256(done, _mm256_cmpgt_epi32(current, reduced));
+                current = _mm256_blendv_epi8(current, reduced, lower);
+                store(slack + j, current);
+                store(slackL + j, _mm256_blendv_epi8(load(slackL + j), row, lower));
+
+                const auto candidate = _mm256_blendv_epi8(current, infinity, done);
+                const auto smaller = _mm256_cmpgt_epi32(best, candidate);
+                best = _mm256_blendv_epi8(best, candidate, smaller);
+                bestIndex = _mm256_blendv_epi8(bestIndex, index, smaller);
+                index = _mm256_add_epi32(index, step);
+            }
+
+            alignas(32) int values[8];
+            alignas(32) int indexes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values), best);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(indexes), bestIndex);
+
+            auto value = std::numeric_limits<int>::max();
+            auto next = count;
+            for(size_t lane = 0; lane < 8; ++lane) {
+                if(values[lane] == std::numeric_limits<int>::max()) continue;
+                if(values[lane] < value || (values[lane] == value && static_cast<size_t>(indexes[lane]) < next)) {
+                    value = values[lane];
+                    next = indexes[lane];
+                }
+            }
+
+            const auto tail = scalar::relax(costs + j, sign, potential, from, potentials + j, slack + j, slackL + j, visited + j, count - j);
+            if(tail < count - j && slack[j + tail] < value) next = j + tail;
+            return next;
+        }
+
+        __attribute__((target("avx2")))
+        void shift(int delta, int* potentials, int* slack, const int* visited, size_t count) {
+            const auto deltas = _mm256_set1_epi32(delta);
+            const auto infinity = _mm256_set1_epi32(std::numeric_limits<int>::max());
+
+            size_t j = 0;
+            for(; j + 8 <= count; j += 8) {
+                const auto done = load(visited + j);
+                const auto current = load(slack + j);
+                const auto keep = _mm256_or_si256(done, _mm256_cmpeq_epi32(current, infinity));
+                store(potentials + j, _mm256_add_epi32(load(potentials + j), _mm256_and_si256(done, deltas)));
+                store(slack + j, _mm256_sub_epi32(current, _mm256_andnot_si256(keep, deltas)));
+            }
+            scalar::shift(delta, potentials + j, slack + j, visited + j, count - j);
+        }
+
+        __attribute__((target("avx2")))
+        size_t tight(const int* costs, int potential, const int* potentials, size_t start, size_t count) {
+            auto j = std::min(count, (start + 7) / 8 * 8);
+            const auto head = scalar::tight(costs, potential, potentials, start, j);
+            if(head < j) return head;
+
+            const auto potentialL = _mm256_set1_epi32(potential);
+            for(; j + 8 <= count; j += 8) {
+                const auto equal = _mm256_cmpeq_epi32(_mm256_add_epi32(potentialL, load(potentials + j)), load_costs(costs + j));
+                const auto bits = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+                if(bits != 0) return j + __builtin_ctz(bits);
+            }
+            return scalar::tight(costs, potential, potentials, j, count);
+        }
+
+        __attribute__((target("avx2")))
+        int reduced_min(const int* costs, int potential, const int* potentials, const int* visited, size_t count) {
+            const auto potentialL = _mm256_set1_epi32(potential);
+            const auto infinity = _mm256_set1_epi32(std::numeric_limits<int>::max());
+            const auto zero = _mm256_setzero_si256();
+
+            auto best = infinity;
+            size_t j = 0;
+            for(; j + 8 <= count; j += 8) {
+                const auto reduced = _mm256_sub_epi32(_mm256_add_epi32(potentialL, load(potentials + j)), load_costs(costs + j));
+                const auto skip = _mm256_or_si256(load(visited + j), _mm256_cmpeq_epi32(reduced, zero));
+                best = _mm256_min_epi32(best, _mm256_blendv_epi8(reduced, infinity, skip));
+            }
+
+            alignas(32) int values[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values), best);
+            return std::min(*std::min_element(values, values + 8),
+                            scalar::reduced_min(costs + j, potential, potentials + j, visited + j, count - j));
+        }
+    }
+
+    namespace sse4 {
+        __attribute__((target("sse4.1")))
+        inline __m128i load(const int* values) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)); }
+
+        __attribute__((target("sse4.1")))
+        inline void store(int* values, __m128i vector) { _mm_storeu_si128(reinterpret_cast<__m128i*>(values), vector); }
+
+        __attribute__((target("sse4.1")))
+        inline __m128i load_costs(const int* costs) { return _mm_load_si128(reinterpret_cast<const __m128i*>(costs)); }
+
+        __attribute__((target("sse4.1")))
+        size_t relax(const int* costs, int sign, int potential, int from, const int* potentials,
+                     int* slack, int* slackL, const int* visited, size_t count) {
+            const auto signs = _mm_set1_epi32(sign);
+            const auto potentialL = _mm_set1_epi32(potential);
+            const auto row = _mm_set1_epi32(from);
+            const auto infinity = _mm_set1_epi32(std::numeric_limits<int>::max());
+            const auto step = _mm_set1_epi32(4);
+
+            auto best = infinity;
+            auto bestIndex = _mm_setzero_si128();
+            auto index = _mm_setr_epi32(0, 1, 2, 3);
+
+            size_t j = 0;
+            for(; j + 4 <= count; j += 4) {
+                const auto weight = _mm_sub_epi32(_mm_xor_si128(load_costs(costs + j), signs), signs);
+                const auto reduced = _mm_sub_epi32(_mm_add_epi32(potentialL, load(potentials + j)), weight);
+                const auto done = load(visited + j);
+
+                auto current = load(slack + j);
+                const auto lower = _mm_andnot_si128(done, _mm_cmpgt_epi32(current, reduced));
+                current = _mm_blendv_epi8(current, reduced, lower);
+                store(slack + j, current);
+                store(slackL + j, _mm_blendv_epi8(load(slackL + j), row, lower));
+
+                const auto candidate = _mm_blendv_epi8(current, infinity, done);
+                const auto smaller = _mm_cmpgt_epi32(best, candidate);
+                best = _mm_blendv_epi8(best, candidate, smaller);
+                bestIndex = _mm_blendv_epi8(bestIndex, index, smaller);
+                index = _mm_add_epi32(index, step);
+            }
+
+            alignas(16) int values[4];
+            alignas(16) int indexes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(values), best);
+            _mm_store_si128(reinterpret_cast<__m128i*>(indexes), bestIndex);
+
+            auto value = std::numeric_limits<int>::max();
+            auto next = count;
+            for(size_t lane = 0; lane < 4; ++lane) {
+                if(values[lane] == std::numeric_limits<int>::max()) continue;
+                if(values[lane] < value || (values[lane] == value && static_cast<size_t>(indexes[lane]) < next)) {
+                    value = values[lane];
+                    next = indexes[lane];
+                }
+            }
+
+            const auto tail = scalar::relax(costs + j, sign, potential, from, potentials + j, slack + j, slackL + j, visited + j, count - j);
+            if(tail < count - j && slack[j + tail] < value) next = j + tail;
+            return next;
+        }
+
+        __attribute__((target("sse4.1")))
+        void shift(int delta, int* potentials, int* slack, const int* visited, size_t count) {
+            const auto deltas = _mm_set1_epi32(delta);
+            const auto infinity = _mm_set1_epi32(std::numeric_limits<int>::max());
+
+            size_t j = 0;
+            for(; j + 4 <= count; j += 4) {
+                const auto done = load(visited + j);
+                const auto current = load(slack + j);
+                const auto keep = _mm_or_si128(done, _mm_cmpeq_epi32(current, infinity));
+                store(potentials + j, _mm_add_epi32(load(potentials + j), _mm_and_si128(done, deltas)));
+                store(slack + j, _mm_sub_epi32(current, _mm_andnot_si128(keep, deltas)));
+            }
+            scalar::shift(delta, potentials + j, slack + j, visited + j, count - j);
+        }
+
+        __attribute__((target("sse4.1")))
+        size_t tight(const int* costs, int potential, const int* potentials, size_t start, size_t count) {
+            auto j = std::min(count, (start + 3) / 4 * 4);
+            const auto head = scalar::tight(costs, potential, potentials, start, j);
+            if(head < j) return head;
+
+            const auto potentialL = _mm_set1_epi32(potential);
+            for(; j + 4 <= count; j += 4) {
+                const auto equal = _mm_cmpeq_epi32(_mm_add_epi32(potentialL, load(potentials + j)), load_costs(costs + j));
+                const auto bits = _mm_movemask_ps(_mm_castsi128_ps(equal));
+                if(bits != 0) return j + __builtin_ctz(bits);
+            }
+            return scalar::tight(costs, potential, potentials, j, count);
+        }
+
+        __attribute__((target("sse4.1")))
+        int reduced_min(const int* costs, int potential, const int* potentials, const int* visited, size_t count) {
+            const auto potentialL = _mm_set1_epi32(potential);
+            const auto infinity = _mm_set1_epi32(std::numeric_limits<int>::max());
+            const auto zero = _mm_setzero_si128();
+
+            auto best = infinity;
+            size_t j = 0;
+            for(; j + 4 <= count; j += 4) {
+                const auto reduced = _mm_sub_epi32(_mm_add_epi32(potentialL, load(potentials + j)), load_costs(costs + j));
+                const auto skip = _mm_or_si128(load(visited + j), _mm_cmpeq_epi32(reduced, zero));
+                best = _mm_min_epi32(best, _mm_blendv_epi8(reduced, infinity, skip));
+            }
+
+            alignas(16) int values[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(values), best);
+            return std::min(*std::min_element(values, values + 4),
+                            scalar::reduced_min(costs + j, potential, potentials + j, visited + j, count - j));
+        }
+    }
+#endif
+
+    // Picked once from the running CPU
+    inline const Table& table() {
+        static const Table selected = [] {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")) return Table{ avx2::relax, avx2::shift, avx2::tight, avx2::reduced_min };
+            if(__builtin_cpu_supports("sse4.1")) return Table{ sse4::relax, sse4::shift, sse4::tight, sse4::reduced_min };
+#endif
+            return Table{ scalar::relax, scalar::shift, scalar::tight, scalar::reduced_min };
+        }();
+        return selected;
+    }
+}
 
 class Graph {
 private:
-    std::vector<std::vector<int>> costs;
+    // Flat row major costs, every row padded with zeros to `stride` columns, a multiple
+    // of 8 that also covers the dummy columns of a matrix with more rows than columns.
+    // A matrix with more columns than rows gets zero dummy rows up to a square.
+    size_t rows;
+    size_t columns;
+    size_t stride;
+    std::vector<int, AlignedAllocator<int, 32>> costs;
 
     std::vector<int> pairL;
     std::vector<int> pairR;
@@ -13,7 +351,33 @@ private:
     std::vector<int> potentialL;
     std::vector<int> potentialR;
 
+    // Scratch of augment_row, one entry per column, one per thread
+    struct Search {
+        std::vector<int> slack;
+        std::vector<int> slackL;      // row the slack of a column comes from
+        std::vector<int> visitedR;    // 0 or -1, the mask the kernels expect
+        std::vector<int> tree;        // rows of the alternating tree
+        std::vector<int> masked;      // forbidden columns hidden from the current row
+    };
+
+    int sign = 1;
+    bool solved = false;              // pairs and potentials are an optimum of the current costs
+    Search search;
+
 private:
+    const int* row_costs(size_t row) const {
+        return costs.data() + row * stride;
+    }
+
+    int cost(size_t row, size_t column) const {
+        return costs[row * stride + column];
+    }
+
+    // First tight column of `from` at or after `start`
+    size_t tight(size_t from, size_t start) const {
+        return kernels::table().tight(row_costs(from), potentialL[from], potentialR.data(), start, columns);
+    }
+
     bool bfs(std::vector<int>& levels, std::vector<bool>& visitedL, std::vector<bool>& visitedR) {
         std::queue<size_t> queue;
         for(size_t i = 0; i < pairL.size(); ++i) {
@@ -33,8 +397,8 @@ private:
                 if(visitedL[from]) continue;
                 visitedL[from] = true;
 
-                for(size_t to = 0; to < costs[from].size(); ++to) {
-                    if(visitedR[to] || (potentialL[from] + potentialR[to] != costs[from][to])) continue;
+                for(auto to = tight(from, 0); to < columns; to = tight(from, to + 1)) {
+                    if(visitedR[to]) continue;
                     visitedR[to] = true;
 
                     if(pairR[to] == -1) {
@@ -57,9 +421,7 @@ private:
         if(visited[from]) return false;
         visited[from] = true;
 
-        for(size_t to = 0; to < costs[from].size(); ++to) {
-            if(potentialL[from] + potentialR[to] != costs[from][to]) continue;
-
+        for(auto to = tight(from, 0); to < columns; to = tight(from, to + 1)) {
             if((pairR[to] == -1) || ((levels[ pairR[to] ] == levels[from] + 1) && dfs(pairR[to], levels, visited))) {
                 pairL[from] = to;
                 pairR[to] = from;
@@ -70,15 +432,16 @@ private:
     }
 
     void update_potentials(const std::vector<bool>& visitedL, const std::vector<bool>& visitedR) {
+        std::vector<int> maskR(visitedR.size());
+        for(size_t j = 0; j < visitedR.size(); ++j) {
+            maskR[j] = visitedR[j] ? -1 : 0;
+        }
+
+        const auto& kernel = kernels::table();
         int delta = std::numeric_limits<int>::max();
         for(size_t i = 0; i < visitedL.size(); ++i) {
             if(!visitedL[i]) continue;
-
-            for(size_t j = 0; j < visitedR.size(); ++j) {
-                if(visitedR[j] || (potentialL[i] + potentialR[j] - costs[i][j] == 0)) continue;
-
-                delta = std::min(delta, potentialL[i] + potentialR[j] - costs[i][j]);
-            }
+            delta = std::min(delta, kernel.reduced_min(row_costs(i), potentialL[i], potentialR.data(), maskR.data(), visitedR.size()));
         }
 
         for(size_t i = 0; i < visitedL.size(); ++i) {
@@ -92,10 +455,136 @@ private:
         }
     }
 
+    // Dummy columns are zero padding of the rows
+    int weight(size_t row, size_t column) const {
+        return sign * cost(row, column);
+    }
+
+    // Matches `row` through a shortest augmenting path in the reduced weights
+    // potentialL[i] + potentialR[j] - weight(i, j) >= 0: the slack of every column is the
+    // smallest reduced weight from a row of the tree, so each step adds the column with
+    // the smallest slack after lowering the potentials by it. A step is O(columns) and
+    // adds a matched row to the tree, so a row costs O(n * columns).
+    // `state` holds the pairs and potentials, the graph itself for solve() or a Murty node.
+    // Rows before `fixed` keep their pairs and their columns stay out of the search, the
+    // row `fixed` can't take the `forbidden` columns. Returns false if no path is left.
+    template <typename State>
+    bool augment_row(size_t row, State& state, Search& search, int sign,
+                     size_t fixed = 0, const std::vector<int>& forbidden = {}) const {
+        auto& [slack, slackL, visitedR, tree, masked] = search;
+
+        const auto count = state.pairR.size();
+        slack.assign(count, std::numeric_limits<int>::max());
+        slackL.assign(count, -1);
+        visitedR.assign(count, 0);
+        tree.assign(1, row);
+        for(size_t i = 0; i < fixed; ++i) {
+            visitedR[ state.pairL[i] ] = -1;
+        }
+
+        const auto& kernel = kernels::table();
+        const auto mask = sign < 0 ? -1 : 0;
+
+        for(auto from = row; ; ) {
+            const auto restricted = from == fixed && !forbidden.empty();
+            if(restricted) {
+                masked.clear();
+                for(const auto column : forbidden) {
+                    if(visitedR[column]) continue;
+                    visitedR[column] = -1;
+                    masked.push_back(column);
+                }
+            }
+
+            auto next = kernel.relax(row_costs(from), mask, state.potentialL[from], from, state.potentialR.data(),
+                                     slack.data(), slackL.data(), visitedR.data(), count);
+
+            if(restricted) {
+                for(const auto column : masked) {
+                    visitedR[column] = 0;
+                    if(slack[column] == std::numeric_limits<int>::max()) continue;
+                    if(next == count || slack[column] < slack[next] || (slack[column] == slack[next] && static_cast<size_t>(column) < next)) next = column;
+                }
+            }
+            if(next == count) return false;
+
+            const auto delta = slack[next];
+            if(delta > 0) {
+                for(const auto i : tree) state.potentialL[i] -= delta;
+                kernel.shift(delta, state.potentialR.data(), slack.data(), visitedR.data(), count);
+            }
+
+            visitedR[next] = -1;
+            if(state.pairR[next] == -1) {
+                for(int to = next; to != -1; ) {
+                    const auto i = slackL[to];
+                    const auto previous = state.pairL[i];
+                    state.pairL[i] = to;
+                    state.pairR[to] = i;
+                    to = previous;
+                }
+                return true;
+            }
+
+            from = state.pairR[next];
+            tree.push_back(from);
+        }
+    }
+
+    // Lowest feasible potential of `row` against the current column potentials
+    int row_potential(size_t row) const {
+        int potential = std::numeric_limits<int>::min();
+        for(size_t j = 0; j < pairR.size(); ++j) {
+            potential = std::max(potential, weight(row, j) - potentialR[j]);
+        }
+        return potential;
+    }
+
+    // Drops the pair of `row` and makes its potential feasible again. With more columns than
+    // rows a column left free must end with potential zero, so lowering the potential of
+    // the freed column can break feasibility for other rows, which are unmatched in turn.
+    void unmatch(size_t row) {
+        std::vector<size_t> pending{ row };
+        while(!pending.empty()) {
+            const auto from = pending.back();
+            pending.pop_back();
+
+            const auto column = pairL[from];
+            if(column != -1) {
+                pairL[from] = -1;
+                pairR[column] = -1;
+
+                if(pairR.size() > rows && potentialR[column] > 0) {
+                    potentialR[column] = 0;
+                    for(size_t i = 0; i < rows; ++i) {
+                        if(potentialL[i] >= weight(i, column)) continue;
+                        potentialL[i] = weight(i, column);
+                        if(pairL[i] != -1) pending.push_back(i);
+                    }
+                }
+            }
+            potentialL[from] = row_potential(from);
+        }
+    }
+
+    long long total() const {
+        long long total_sum = 0;
+        for(size_t i = 0; i < rows; ++i) {
+            if(pairL[i] != -1 && static_cast<size_t>(pairL[i]) < columns) total_sum += cost(i, pairL[i]);
+        }
+        return total_sum;
+    }
+
 public:
-    explicit Graph(const std::vector<std::vector<int>>& costs) : costs(costs) {
-        const auto n = costs.size();        // L-vertixes
-        const auto m = costs[0].size();     // R-vertixes
+    explicit Graph(const std::vector<std::vector<int>>& costs) : rows(costs.size()), columns(costs[0].size()) {
+        const auto n = rows;        // L-vertixes
+        const auto m = columns;     // R-vertixes
+
+        stride = (std::max(n, m) + 7) / 8 * 8;
+        this->costs.assign(std::max(n, m) * stride, 0);
+        for(size_t i = 0; i < n; ++i) {
+            std::copy(costs[i].begin(), costs[i].end(), this->costs.begin() + i * stride);
+        }
 
         pairL.assign(n, -1);
         pairR.assign(m, -1);
@@ -105,14 +594,15 @@ public:
 
         for(size_t i = 0; i < n; ++i) {
             for(size_t j = 0; j < m; ++j) {
-                potentialL[i] = std::max(potentialL[i], costs[i][j]);
+                potentialL[i] = std::max(potentialL[i], cost(i, j));
             }
         }
     }
 
     int max_matching() {
+        solved = false;
         size_t matches_counter = 0;
-        while(matches_counter < std::min(costs.size(), costs[0].size())) {   // Until we get a perfect matching
+        while(matches_counter < std::min(rows, columns)) {   // Until we get a perfect matching
 
             std::vector<bool> visitedL(pairL.size(), false);
             std::vector<bool> visitedR(pairR.size(), false);
@@ -133,16 +623,215 @@ public:
         int total_sum = 0;
         for(size_t i = 0; i < pairL.size(); ++i) {
             if(pairL[i] != -1) {
-                total_sum += costs[i][pairL[i]];
+                total_sum += cost(i, pairL[i]);
             }
         }
 
         return total_sum;
     }
 
+    // Kuhn-Munkres with slack arrays (Jonker-Volgenant style), O(n^2 m). A rectangular
+    // matrix with more rows than columns is padded with zero cost columns, the rows
+    // matched to them stay unassigned. Returns the total cost of the assignment.
+    long long solve(Objective objective = Objective::Maximize) {
+        const auto n = rows;
+        const auto m = columns;
+        sign = objective == Objective::Maximize ? 1 : -1;
+
+        pairL.assign(n, -1);
+        pairR.assign(std::max(n, m), -1);
+
+        potentialL.assign(n, std::numeric_limits<int>::min());
+        potentialR.assign(pairR.size(), 0);
+        for(size_t i = 0; i < n; ++i) {
+            for(size_t j = 0; j < pairR.size(); ++j) {
+                potentialL[i] = std::max(potentialL[i], weight(i, j));
+            }
+        }
+
+        for(size_t row = 0; row < n; ++row) {
+            augment_row(row, *this, search, sign);
+        }
+
+        solved = true;
+        return total();
+    }
+
+    // Changes one cost. After a solve() the row is unmatched only when its potential or its
+    // pair stop being valid for the new cost; resolve() matches it again.
+    void update_cost(size_t row, size_t column, int value) {
+        costs[row * stride + column] = value;
+        if(!solved) return;
+
+        const auto reduced = potentialL[row] + potentialR[column] - weight(row, column);
+        if(reduced < 0 || (pairL[row] == static_cast<int>(column) && reduced != 0)) unmatch(row);
+    }
+
+    void update_row(size_t row, const std::vector<int>& values) {
+        std::copy(values.begin(), values.end(), costs.begin() + row * stride);
+        if(solved) unmatch(row);
+    }
+
+    // Same result as solve() with the last objective, but starts from the retained potentials
+    // and matching and only augments the rows the updates unmatched, O(k n m) for k of them
+    long long resolve() {
+        if(!solved) return solve(sign > 0 ? Objective::Maximize : Objective::Minimize);
+
+        for(size_t row = 0; row < rows; ++row) {
+            if(pairL[row] == -1) augment_row(row, *this, search, sign);
+        }
+        return total();
+    }
+
+    struct Assignment {
+        long long total;
+        std::vector<int> pairL;       // -1 for a row left unassigned
+    };
+
+    // Assignments from the best one down, with Murty's partitioning of the square padded
+    // problem. Taking an assignment splits the rest of its subproblem into one child per
+    // row from its first free one on: the rows before keep their pairs and the row can't
+    // take its column. Every child starts from the parent's pairs and potentials with that
+    // row unmatched, so it is solved by a single augment_row, and the children of one
+    // assignment are solved in parallel. Reads the costs of the graph, which has to stay
+    // alive and unchanged.
+    class Ranking {
+    private:
+        struct Node {
+            long long score;                  // total, negated for Minimize
+            size_t order;                     // creation order, breaks ties
+            size_t fixed;                     // rows before it keep their pairs
+            std::vector<int> forbidden;       // columns the row `fixed` can't take
+            std::vector<int> pairL;
+            std::vector<int> pairR;
+            std::vector<int> potentialL;
+            std::vector<int> potentialR;
+        };
+
+        const Graph& graph;
+        int sign;
+        size_t threads;
+        size_t created = 0;
+
+        std::vector<Node> heap;
+        std::optional<Node> pending;          // returned last, children not made yet
+
+    private:
+        static bool worse(const Node& a, const Node& b) {
+            return a.score != b.score ? a.score < b.score : a.order > b.order;
+        }
+
+        long long total(const Node& node) const {
+            long long total_sum = 0;
+            for(size_t i = 0; i < graph.rows; ++i) {
+                if(static_cast<size_t>(node.pairL[i]) < graph.columns) total_sum += graph.cost(i, node.pairL[i]);
+            }
+            return total_sum;
+        }
+
+        std::optional<Node> child(const Node& parent, size_t row, Search& search) const {
+            Node node{ 0, 0, row, {}, parent.pairL, parent.pairR, parent.potentialL, parent.potentialR };
+            if(row == parent.fixed) node.forbidden = parent.forbidden;
+
+            // Every dummy column leaves the row unassigned, so they go together
+            const auto column = node.pairL[row];
+            if(static_cast<size_t>(column) < graph.columns) {
+                node.forbidden.push_back(column);
+            } else {
+                for(auto j = graph.columns; j < node.pairR.size(); ++j) node.forbidden.push_back(j);
+            }
+
+            node.pairL[row] = -1;
+            node.pairR[column] = -1;
+            if(!graph.augment_row(row, node, search, sign, row, node.forbidden)) return std::nullopt;
+
+            node.score = sign * total(node);
+            return node;
+        }
+
+        void expand(const Node& parent) {
+            const auto first = parent.fixed;
+            const auto count = graph.rows - first;
+            std::vector<std::optional<Node>> children(count);
+            std::atomic<size_t> next(0);
+
+            auto work = [&]() {
+                Search search;
+                for(auto i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    children[i] = child(parent, first + i, search);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for(size_t thread = 1; thread < std::min(threads, count); ++thread) {
+                workers.emplace_back(work);
+            }
+            work();
+            for(auto& worker : workers) worker.join();
+
+            for(auto& node : children) {
+                if(!node) continue;
+                node->order = created++;
+                heap.push_back(std::move(*node));
+                std::push_heap(heap.begin(), heap.end(), worse);
+            }
+        }
+
+    public:
+        // threads == 0 picks std::thread::hardware_concurrency()
+        Ranking(const Graph& graph, Objective objective, size_t threads)
+            : graph(graph), sign(objective == Objective::Maximize ? 1 : -1), threads(threads) {
+            if(this->threads == 0) this->threads = std::max(1u, std::thread::hardware_concurrency());
+
+            const auto size = std::max(graph.rows, graph.columns);
+            Node root{ 0, created++, 0, {}, std::vector<int>(size, -1), std::vector<int>(size, -1),
+                       std::vector<int>(size, std::numeric_limits<int>::min()), std::vector<int>(size, 0) };
+            for(size_t i = 0; i < size; ++i) {
+                for(size_t j = 0; j < size; ++j) {
+                    root.potentialL[i] = std::max(root.potentialL[i], sign * graph.cost(i, j));
+                }
+            }
+
+            Search search;
+            for(size_t row = 0; row < size; ++row) {
+                graph.augment_row(row, root, search, sign);
+            }
+            root.score = sign * total(root);
+            heap.push_back(std::move(root));
+        }
+
+        // Next best assignment, nothing once they are all out. Non-increasing totals for
+        // Maximize, non-decreasing for Minimize.
+        std::optional<Assignment> next() {
+            if(pending) {
+                expand(*pending);
+                pending.reset();
+            }
+            if(heap.empty()) return std::nullopt;
+
+            std::pop_heap(heap.begin(), heap.end(), worse);
+            pending = std::move(heap.back());
+            heap.pop_back();
+
+            Assignment assignment{ sign * pending->score, std::vector<int>(graph.rows, -1) };
+            for(size_t i = 0; i < graph.rows; ++i) {
+                if(static_cast<size_t>(pending->pairL[i]) < graph.columns) assignment.pairL[i] = pending->pairL[i];
+            }
+            return assignment;
+        }
+    };
+
+    Ranking rank(Objective objective = Objective::Maximize, size_t threads = 0) const {
+        return Ranking(*this, objective, threads);
+    }
+
     void print() const {
         for(size_t i = 0; i < pairL.size(); ++i) {
-            std::cout << "l: " << i << ", r: " << pairL[i] << ", cost: " << costs[i][ pairL[i] ] << std::endl;
+            if(pairL[i] == -1 || static_cast<size_t>(pairL[i]) >= columns) {
+                std::cout << "l: " << i << ", r: -1" << std::endl;
+                continue;
+            }
+            std::cout << "l: " << i << ", r: " << pairL[i] << ", cost: " << cost(i, pairL[i]) << std::endl;
         }
     }
 };
@@ -170,5 +859,20 @@ int main() {
     std::cout << "Max matching: " << graph.max_matching() << std::endl << std::endl;
 
     graph.print();
+
+    std::cout << std::endl << "Kuhn-Munkres max: " << graph.solve(Objective::Maximize) << std::endl;
+    std::cout << "Kuhn-Munkres min: " << graph.solve(Objective::Minimize) << std::endl << std::endl;
+    graph.print();
+
+    graph.update_cost(0, 4, 9);
+    graph.update_row(3, { 1, 9, 6, 7, 5, 6, 3 });
+    std::cout << std::endl << "Kuhn-Munkres min after updates: " << graph.resolve() << std::endl;
+
+    auto ranking = graph.rank(Objective::Maximize, 4);
+    std::cout << std::endl << "Best assignments:";
+    for(size_t k = 0; k < 5; ++k) {
+        std::cout << " " << ranking.next()->total;
+    }
+    std::cout << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <optional>
+#include <functional>
+
+enum class Objective { Minimize, Maximize };
+
+// Assignment over a sparse list of allowed { row, column, cost } pairs, 0-based; every
+// other pair is forbidden. Rows are matched one by one through a Dijkstra shortest
+// augmenting path in the reduced costs weight - potentialL[row] - potentialR[column] >= 0,
+// which stays O(n + m + E) in memory and costs O(E log E) per row.
+class Graph {
+private:
+    static constexpr long long infinity = std::numeric_limits<long long>::max();
+
+    std::vector<size_t> offsets;    // CSR of the rows
+    std::vector<int> adjacency;     // column of every edge
+    std::vector<int> costs;         // cost of every edge
+
+    std::vector<int> pairL;
+    std::vector<int> pairR;
+    std::vector<size_t> edgeL;      // edge matching every row
+
+    std::vector<long long> potentialL;
+    std::vector<long long> potentialR;
+
+    // Dijkstra state of a column, reset through `touched` so a row only pays for what it reaches
+    int sign = 1;
+    std::vector<long long> distance;
+    std::vector<int> parentL;
+    std::vector<size_t> parentEdge;
+    std::vector<bool> done;
+    std::vector<int> touched;
+    std::vector<int> finished;
+
+private:
+    long long weight(size_t edge) const {
+        return static_cast<long long>(sign) * costs[edge];
+    }
+
+    // Returns false when no augmenting path starts at `row`, i.e. the rows up to it can't all be matched
+    bool augment(int row) {
+        if(offsets[row] == offsets[row + 1]) return false;
+
+        potentialL[row] = infinity;
+        for(auto edge = offsets[row]; edge < offsets[row + 1]; ++edge) {
+            potentialL[row] = std::min(potentialL[row], weight(edge) - potentialR[ adjacency[edge] ]);
+        }
+
+        using Entry = std::pair<long long, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+        auto relax = [&](int from, long long base) {
+            for(auto edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+                const auto to = adjacency[edge];
+                if(done[to]) continue;
+
+                const auto reduced = base + weight(edge) - potentialL[from] - potentialR[to];
+                if(distance[to] == infinity) touched.push_back(to);
+                if(reduced < distance[to]) {
+                    distance[to] = reduced;
+                    parentL[to] = from;
+                    parentEdge[to] = edge;
+                    heap.emplace(reduced, to);
+                }
+            }
+        };
+
+        touched.clear();
+        finished.clear();
+        relax(row, 0);
+
+        int free = -1;
+        while(!heap.empty()) {
+            const auto [length, column] = heap.top();
+            heap.pop();
+            if(done[column] || length > distance[column]) continue;
+
+            done[column] = true;
+            finished.push_back(column);
+            if(pairR[column] == -1) {
+                free = column;
+                break;
+            }
+            relax(pairR[column], length);
+        }
+
+        if(free != -1) {
+            // Keeps every reduced cost non-negative and the ones along the matching at zero
+            const auto shortest = distance[free];
+            for(const auto column : finished) {
+                potentialR[column] += distance[column] - shortest;
+                if(pairR[column] != -1) potentialL[ pairR[column] ] += shortest - distance[column];
+            }
+            potentialL[row] += shortest;
+
+            for(auto to = free; ; ) {
+                const auto from = parentL[to];
+                const auto previous = pairL[from];
+                pairL[from] = to;
+                pairR[to] = from;
+                edgeL[from] = parentEdge[to];
+                if(from == row) break;
+                to = previous;
+            }
+        }
+
+        for(const auto column : touched) {
+            distance[column] = infinity;
+            done[column] = false;
+        }
+        return free != -1;
+    }
+
+public:
+    Graph(size_t n, size_t m, const std::vector<std::vector<int>>& edges) {
+        pairL.assign(n, -1);
+        pairR.assign(m, -1);
+
+        offsets.assign(n + 1, 0);
+        for(const auto& edge : edges) {
+            ++offsets[ edge[0] + 1 ];
+        }
+        for(size_t u = 0; u < n; ++u) offsets[u + 1] += offsets[u];
+
+        adjacency.resize(edges.size());
+        costs.resize(edges.size());
+        std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+        for(const auto& edge : edges) {
+            const auto index = position[ edge[0] ]++;
+            adjacency[index] = edge[1];
+            costs[index] = edge[2];
+        }
+    }
+
+    // Matches every row, columns may be left over. Returns the total cost, or nothing
+    // when the allowed pairs have no matching that covers all the rows.
+    std::optional<long long> solve(Objective objective = Objective::Maximize) {
+        const auto n = pairL.size();
+        const auto m = pairR.size();
+        sign = objective == Objective::Maximize ? -1 : 1;
+
+        pairL.assign(n, -1);
+        pairR.assign(m, -1);
+        edgeL.assign(n, 0);
+        if(n > m) return std::nullopt;
+
+        potentialL.assign(n, 0);
+        potentialR.assign(m, 0);
+
+        distance.assign(m, infinity);
+        parentL.assign(m, -1);
+        parentEdge.assign(m, 0);
+        done.assign(m, false);
+
+        for(size_t row = 0; row < n; ++row) {
+            if(!augment(row)) return std::nullopt;
+        }
+
+        long long total_sum = 0;
+        for(size_t i = 0; i < n; ++i) {
+            total_sum += costs[ edgeL[i] ];
+        }
+        return total_sum;
+    }
+
+    void print() const {
+        for(size_t i = 0; i < pairL.size(); ++i) {
+            if(pairL[i] == -1) {
+                std::cout << "l: " << i << ", r: -1" << std::endl;
+                continue;
+            }
+            std::cout << "l: " << i << ", r: " << pairL[i] << ", cost: " << costs[ edgeL[i] ] << std::endl;
+        }
+    }
+};
+
+int main() {
+    std::vector<std::vector<int>> edges = {
+        { 0, 1, 10 }, { 0, 4,  2 },
+        { 1, 3, 12 }, { 1, 6,  2 },
+        { 2, 0, 11 }, { 2, 6, 15 },
+        { 3, 1,  9 }, { 3, 2,  6 }, { 3, 0,  3 },
+        { 4, 1,  6 }, { 4, 3,  3 },
+        { 5, 2, 11 }, { 5, 4, 11 }, { 5, 5,  2 },
+        { 6, 5,  6 }, { 6, 6,  8 }
+    };
+
+    Graph graph(7, 7, edges);
+    std::cout << "Sparse assignment max: " << *graph.solve(Objective::Maximize) << std::endl;
+
+    const auto minimum = graph.solve(Objective::Minimize);
+    std::cout << "Sparse assignment min: " << *minimum << std::endl << std::endl;
+    graph.print();
+
+    Graph infeasible(3, 3, { { 0, 0, 1 }, { 1, 0, 2 }, { 2, 1, 3 } });
+    std::cout << std::endl << "Perfect matching: " << (infeasible.solve() ? "yes" : "no") << std::endl;
+    return 0;
+}
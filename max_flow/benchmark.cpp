@@ -0,0 +1,336 @@
+// Benchmark of the max-flow solvers in this directory on generated instances.
+// Every (instance, solver) run happens in a forked child so peak RSS is per solver;
+// results are printed as one JSON object per line.
+//
+//     g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+//     ./benchmark [--scale N] [--threads N] [--seed N]
+
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <random>
+#include <chrono>
+#include <array>
+#include <utility>
+#include <unordered_map>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_FLOW_BENCHMARK
+
+namespace edmonds_karp {
+#include "edmonds_karp.cpp"
+}
+namespace ford_fulkerson {
+#include "ford_fulkerson.cpp"
+}
+namespace dinic {
+#include "dinic.cpp"
+}
+namespace push_relabel {
+#include "push_relabel.cpp"
+}
+namespace parallel_push_relabel {
+#include "parallel_push_relabel.cpp"
+}
+
+struct Arc {
+    size_t from;
+    size_t to;
+    int capacity;
+};
+
+struct Instance {
+    std::string name;
+    size_t vertices = 0;
+    size_t source = 0;
+    size_t sink = 0;
+    std::vector<Arc> arcs;
+};
+
+struct Result {
+    size_t flow = 0;
+    size_t operations = 0;
+    double seconds = 0;
+    long peak_rss_kb = 0;
+};
+
+using Generator = std::function<Instance()>;
+
+// Random sparse graph, `degree` arcs per vertex on average
+Instance random_sparse(size_t vertices, size_t degree, int max_capacity, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<size_t> vertex(0, vertices - 1);
+    std::uniform_int_distribution<int> capacity(1, max_capacity);
+
+    Instance instance{ "random_sparse", vertices, 0, vertices - 1, {} };
+    for(size_t i = 0; i < vertices * degree; ++i) {
+        const auto from = vertex(random), to = vertex(random);
+        if(from != to) instance.arcs.push_back({ from, to, capacity(random) });
+    }
+    return instance;
+}
+
+// Vision-style 4-connected grid, every pixel has terminal arcs to the source and the sink
+Instance grid(size_t width, size_t height, int max_capacity, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> capacity(0, max_capacity);
+
+    const auto pixels = width * height;
+    Instance instance{ "grid", pixels + 2, pixels, pixels + 1, {} };
+    for(size_t y = 0; y < height; ++y) {
+        for(size_t x = 0; x < width; ++x) {
+            const auto pixel = y * width + x;
+            instance.arcs.push_back({ instance.source, pixel, capacity(random) });
+            instance.arcs.push_back({ pixel, instance.sink, capacity(random) });
+
+            if(x + 1 < width) {
+                instance.arcs.push_back({ pixel, pixel + 1, capacity(random) });
+                instance.arcs.push_back({ pixel + 1, pixel, capacity(random) });
+            }
+            if(y + 1 < height) {
+                instance.arcs.push_back({ pixel, pixel + width, capacity(random) });
+                instance.arcs.push_back({ pixel + width, pixel, capacity(random) });
+            }
+        }
+    }
+    return instance;
+}
+
+// AK-style network after Cherkassky and Goldberg: a long path leaking one unit to the
+// sink at every vertex (long augmenting paths, many relabels along the path) next to a
+// chain feeding a shared bottleneck vertex (many pushes against the same arcs)
+Instance ak(size_t k) {
+    Instance instance{ "ak", 2 * k + 3, 0, 1, {} };
+    const auto path = [](size_t i) { return 2 + i; };
+    const auto chain = [k](size_t i) { return 2 + k + i; };
+    const auto bottleneck = 2 + 2 * k;
+    const auto side = static_cast<int>(k);
+
+    instance.arcs.push_back({ instance.source, path(0), side + 1 });
+    instance.arcs.push_back({ instance.source, chain(0), side });
+    for(size_t i = 0; i < k; ++i) {
+        if(i + 1 < k) {
+            instance.arcs.push_back({ path(i), path(i + 1), side - static_cast<int>(i) });
+            instance.arcs.push_back({ chain(i), chain(i + 1), side });
+        }
+        instance.arcs.push_back({ path(i), instance.sink, 1 });
+        instance.arcs.push_back({ chain(i), bottleneck, 1 });
+    }
+    instance.arcs.push_back({ bottleneck, instance.sink, side });
+    return instance;
+}
+
+// `layers` layers of `width` vertices, `degree` random arcs into the next layer
+Instance layered(size_t layers, size_t width, size_t degree, int max_capacity, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<size_t> column(0, width - 1);
+    std::uniform_int_distribution<int> capacity(1, max_capacity);
+
+    Instance instance{ "layered", layers * width + 2, layers * width, layers * width + 1, {} };
+    for(size_t v = 0; v < width; ++v) {
+        instance.arcs.push_back({ instance.source, v, capacity(random) * static_cast<int>(degree) });
+        instance.arcs.push_back({ (layers - 1) * width + v, instance.sink, capacity(random) * static_cast<int>(degree) });
+    }
+    for(size_t layer = 0; layer + 1 < layers; ++layer) {
+        for(size_t v = 0; v < width; ++v) {
+            for(size_t i = 0; i < degree; ++i) {
+                instance.arcs.push_back({ layer * width + v, (layer + 1) * width + column(random), capacity(random) });
+            }
+        }
+    }
+    return instance;
+}
+
+// Transportation problem: supplies on the left, demands on the right, random routes
+Instance transport(size_t suppliers, size_t consumers, size_t degree, int max_capacity, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<size_t> consumer(0, consumers - 1);
+    std::uniform_int_distribution<int> capacity(1, max_capacity);
+
+    const auto vertices = suppliers + consumers + 2;
+    Instance instance{ "transport", vertices, vertices - 2, vertices - 1, {} };
+    for(size_t s = 0; s < suppliers; ++s) {
+        instance.arcs.push_back({ instance.source, s, capacity(random) * static_cast<int>(degree) / 2 });
+        for(size_t i = 0; i < degree; ++i) {
+            instance.arcs.push_back({ s, suppliers + consumer(random), capacity(random) });
+        }
+    }
+    for(size_t c = 0; c < consumers; ++c) {
+        instance.arcs.push_back({ suppliers + c, instance.sink, capacity(random) * static_cast<int>(degree) / 2 });
+    }
+    return instance;
+}
+
+struct Solver {
+    std::string name;
+    std::string operation;
+    size_t max_vertices;    // dense matrix solvers are skipped on bigger instances
+    std::function<std::pair<size_t, size_t>(const Instance&, std::chrono::steady_clock::time_point&)> run;
+};
+
+// Builds the solver's graph, starts the clock right before max_flow
+template <typename Graph, typename Solve, typename Operations>
+std::pair<size_t, size_t> run(Graph& graph, const Instance& instance, std::chrono::steady_clock::time_point& start, Solve solve, Operations operations) {
+    for(const auto& arc : instance.arcs) {
+        graph.add_edge(arc.from, arc.to, arc.capacity);
+    }
+    start = std::chrono::steady_clock::now();
+    const auto flow = solve(graph);
+    return { static_cast<size_t>(flow), operations(graph) };
+}
+
+std::vector<Solver> solvers(size_t threads) {
+    const size_t dense = 1000;
+    const size_t any = std::numeric_limits<size_t>::max();
+
+    return {
+        { "edmonds_karp", "augmentations", dense, [](const Instance& instance, auto& start) {
+            edmonds_karp::Graph graph(instance.vertices);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.augmentations(); });
+        } },
+        { "edmonds_karp_dense", "augmentations", dense, [](const Instance& instance, auto& start) {
+            edmonds_karp::Graph graph(instance.vertices, true);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.augmentations(); });
+        } },
+        { "ford_fulkerson", "augmentations", dense, [](const Instance& instance, auto& start) {
+            ford_fulkerson::Graph<long long> graph(instance.vertices);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.augmentations(); });
+        } },
+        { "ford_fulkerson_scaling", "augmentations", dense, [](const Instance& instance, auto& start) {
+            ford_fulkerson::Graph<long long> graph(instance.vertices);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow_scaling(instance.source, instance.sink); }, [](auto& g) { return g.augmentations(); });
+        } },
+        { "dinic", "augmentations", any, [](const Instance& instance, auto& start) {
+            dinic::Graph graph(instance.vertices);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.augmentations(); });
+        } },
+        { "push_relabel", "pushes", any, [](const Instance& instance, auto& start) {
+            push_relabel::Graph graph(instance.vertices);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.pushes(); });
+        } },
+        { "parallel_push_relabel", "pushes", any, [threads](const Instance& instance, auto& start) {
+            parallel_push_relabel::Graph graph(instance.vertices, threads);
+            return run(graph, instance, start, [&](auto& g) { return g.max_flow(instance.source, instance.sink); }, [](auto& g) { return g.pushes(); });
+        } },
+    };
+}
+
+// Runs one solver in a child process, the child reports its Result through a pipe
+bool measure(const Generator& generate, const Solver& solver, Result& result) {
+    int channel[2];
+    if(::pipe(channel) != 0) return false;
+
+    const auto child = ::fork();
+    if(child < 0) return false;
+
+    if(child == 0) {
+        ::close(channel[0]);
+
+        const auto instance = generate();
+        std::chrono::steady_clock::time_point start;
+        const auto [flow, operations] = solver.run(instance, start);
+        const auto finish = std::chrono::steady_clock::now();
+
+        struct rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+
+        Result child_result{ flow, operations, std::chrono::duration<double>(finish - start).count(), usage.ru_maxrss };
+        const auto written = ::write(channel[1], &child_result, sizeof(child_result));
+        ::_exit(written == sizeof(child_result) ? 0 : 1);
+    }
+
+    ::close(channel[1]);
+    const auto received = ::read(channel[0], &result, sizeof(result));
+    ::close(channel[0]);
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    return received == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv) {
+    size_t scale = 1;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = 1;
+
+    for(int i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const auto value = std::stoull(argv[i + 1]);
+
+        if(option == "--scale") scale = std::max<size_t>(1, value);
+        else if(option == "--threads") threads = std::max<size_t>(1, value);
+        else if(option == "--seed") seed = value;
+        else {
+            std::cerr << "usage: " << argv[0] << " [--scale N] [--threads N] [--seed N]" << std::endl;
+            return 2;
+        }
+    }
+
+    const std::vector<Generator> generators = {
+        [=] { return random_sparse(1000 * scale, 8, 1000, seed); },
+        [=] { return grid(24 * scale, 24 * scale, 100, seed); },
+        [=] { return ak(400 * scale); },
+        [=] { return layered(10, 60 * scale, 5, 100, seed); },
+        [=] { return transport(300 * scale, 300 * scale, 10, 100, seed); },
+    };
+
+    bool consistent = true;
+    for(const auto& generate : generators) {
+        const auto instance = generate();
+
+        size_t expected_flow = std::numeric_limits<size_t>::max();
+        for(const auto& solver : solvers(threads)) {
+            if(instance.vertices > solver.max_vertices) continue;
+
+            Result result;
+            if(!measure(generate, solver, result)) {
+                std::cerr << solver.name << " failed on " << instance.name << std::endl;
+                consistent = false;
+                continue;
+            }
+
+            if(expected_flow == std::numeric_limits<size_t>::max()) expected_flow = result.flow;
+            if(result.flow != expected_flow) {
+                std::cerr << solver.name << " disagrees on " << instance.name << ": " << result.flow << " vs " << expected_flow << std::endl;
+                consistent = false;
+            }
+
+            std::cout << "{\"instance\": \"" << instance.name << "\""
+                      << ", \"vertices\": " << instance.vertices
+                      << ", \"edges\": " << instance.arcs.size()
+                      << ", \"solver\": \"" << solver.name << "\""
+                      << ", \"threads\": " << (solver.name == "parallel_push_relabel" ? threads : 1)
+                      << ", \"flow\": " << result.flow
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"" << solver.operation << "\": " << result.operations
+                      << ", \"peak_rss_kb\": " << result.peak_rss_kb
+                      << ", \"edges_per_second\": " << (result.seconds > 0 ? instance.arcs.size() / result.seconds : 0)
+                      << "}" << std::endl;
+        }
+    }
+
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,571 @@
+#include <vector>
+#include <deque>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+
+// Boykov-Kolmogorov max flow: a source tree and a sink tree are grown towards each
+// other, and after an augmentation the trees are repaired by adopting the orphaned
+// vertices instead of searching again from scratch. The solver is templated on the
+// topology, which only has to expose
+//
+//     size_t size() const
+//     void build()
+//     bool for_each_arc(size_t vertex, Visit visit)    // visit(arc, head) returns true to stop
+//     size_t head(size_t arc) const
+//     size_t reverse(size_t arc) const
+//     int& residual(size_t arc)
+//
+// `Graph` is a CSR graph built from an edge list, `GridGraph` an implicit 2D/3D grid.
+
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+    };
+
+    size_t _size;
+    std::vector<Edge> _edges;
+
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<int> _residual;
+
+public:
+    explicit Graph(size_t size) : _size(size) {}
+
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    void build() {
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(const auto& edge : _edges) {
+            const auto forward = position[edge.from]++;
+            const auto backward = position[edge.to]++;
+
+            _heads[forward] = edge.to;
+            _reverse[forward] = backward;
+            _residual[forward] = edge.capacity;
+
+            _heads[backward] = edge.from;
+            _reverse[backward] = forward;
+            _residual[backward] = 0;
+        }
+    }
+
+    template <typename Visit>
+    bool for_each_arc(size_t vertex, Visit visit) const {
+        for(auto arc = _offsets[vertex]; arc < _offsets[vertex + 1]; ++arc) {
+            if(visit(arc, _heads[arc])) return true;
+        }
+        return false;
+    }
+
+    size_t head(size_t arc) const {
+        return _heads[arc];
+    }
+
+    size_t reverse(size_t arc) const {
+        return _reverse[arc];
+    }
+
+    int& residual(size_t arc) {
+        return _residual[arc];
+    }
+
+    // Residual capacity from -> to, summed over parallel and reverse arcs
+    int get_capacity(size_t from, size_t to) const {
+        int capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
+    }
+};
+
+// Implicit width x height x depth grid with two terminal vertices, source() and sink().
+// No adjacency is stored: an arc is (direction, pixel) and the residual capacities are
+// one array per direction, followed by the four terminal directions.
+class GridGraph {
+public:
+    enum class Neighbourhood { Four, Eight, Six, TwentySix };
+
+private:
+    size_t _width;
+    size_t _height;
+    size_t _depth;
+    size_t _pixels;
+
+    std::vector<std::array<int, 3>> _directions;    // direction d ^ 1 is the opposite of d
+    std::vector<long long> _offsets;               // pixel index delta of every direction
+
+    // Blocks of _pixels arcs: one per direction, then pixel -> source, pixel -> sink,
+    // source -> pixel and sink -> pixel
+    std::vector<int> _residual;
+
+private:
+    size_t block(size_t arc) const {
+        return arc / _pixels;
+    }
+
+    static bool inside(size_t coordinate, int delta, size_t limit) {
+        return delta >= 0 ? coordinate + delta < limit : coordinate >= static_cast<size_t>(-delta);
+    }
+
+public:
+    GridGraph(size_t width, size_t height, size_t depth, Neighbourhood neighbourhood)
+        : _width(width), _height(height), _depth(depth), _pixels(width * height * depth) {
+        std::vector<std::array<int, 3>> positive;
+        for(int dz = -1; dz <= 1; ++dz) {
+            for(int dy = -1; dy <= 1; ++dy) {
+                for(int dx = -1; dx <= 1; ++dx) {
+                    const auto first = dx != 0 ? dx : dy != 0 ? dy : dz;
+                    if(first <= 0) continue;
+
+                    const auto axis = std::abs(dx) + std::abs(dy) + std::abs(dz) == 1;
+                    const auto planar = dz == 0;
+                    if((neighbourhood == Neighbourhood::Four && !(axis && planar))
+                       || (neighbourhood == Neighbourhood::Eight && !planar)
+                       || (neighbourhood == Neighbourhood::Six && !axis)) continue;
+
+                    positive.push_back({ dx, dy, dz });
+                }
+            }
+        }
+        std::stable_sort(positive.begin(), positive.end(), [](const auto& a, const auto& b) {
+            return std::abs(a[0]) + std::abs(a[1]) + std::abs(a[2]) < std::abs(b[0]) + std::abs(b[1]) + std::abs(b[2]);
+        });
+
+        for(const auto& direction : positive) {
+            _directions.push_back(direction);
+            _directions.push_back({ -direction[0], -direction[1], -direction[2] });
+        }
+        for(const auto& [dx, dy, dz] : _directions) {
+            _offsets.push_back(dx + static_cast<long long>(_width) * (dy + static_cast<long long>(_height) * dz));
+        }
+
+        _residual.assign((_directions.size() + 4) * _pixels, 0);
+    }
+
+    size_t pixel(size_t x, size_t y, size_t z = 0) const {
+        return x + _width * (y + _height * z);
+    }
+
+    size_t directions() const {
+        return _directions.size();
+    }
+
+    // <dx, dy, dz> of a direction
+    const std::array<int, 3>& direction(size_t index) const {
+        return _directions[index];
+    }
+
+    size_t source() const {
+        return _pixels;
+    }
+
+    size_t sink() const {
+        return _pixels + 1;
+    }
+
+    // Capacity of pixel -> its neighbour in `direction`, ignored on the border of the grid
+    void set_capacity(size_t pixel, size_t direction, int capacity) {
+        _residual[direction * _pixels + pixel] = capacity;
+    }
+
+    // Capacities of source -> pixel and pixel -> sink
+    void set_terminals(size_t pixel, int source_capacity, int sink_capacity) {
+        const auto directions = _directions.size();
+        _residual[(directions + 2) * _pixels + pixel] = source_capacity;
+        _residual[(directions + 1) * _pixels + pixel] = sink_capacity;
+    }
+
+    // Residual capacity of pixel -> its neighbour in `direction`
+    int get_capacity(size_t pixel, size_t direction) const {
+        return _residual[direction * _pixels + pixel];
+    }
+
+    size_t size() const {
+        return _pixels + 2;
+    }
+
+    void build() {}
+
+    template <typename Visit>
+    bool for_each_arc(size_t vertex, Visit visit) const {
+        const auto directions = _directions.size();
+
+        if(vertex >= _pixels) {
+            const auto first = (vertex == source() ? directions + 2 : directions + 3) * _pixels;
+            for(size_t pixel = 0; pixel < _pixels; ++pixel) {
+                if(visit(first + pixel, pixel)) return true;
+            }
+            return false;
+        }
+
+        const auto x = vertex % _width;
+        const auto y = vertex / _width % _height;
+        const auto z = vertex / (_width * _height);
+
+        for(size_t d = 0; d < directions; ++d) {
+            const auto& [dx, dy, dz] = _directions[d];
+            if(!inside(x, dx, _width) || !inside(y, dy, _height) || !inside(z, dz, _depth)) continue;
+            if(visit(d * _pixels + vertex, vertex + _offsets[d])) return true;
+        }
+
+        if(visit(directions * _pixels + vertex, source())) return true;
+        return visit((directions + 1) * _pixels + vertex, sink());
+    }
+
+    size_t head(size_t arc) const {
+        const auto directions = _directions.size();
+        const auto d = block(arc);
+        const auto pixel = arc % _pixels;
+
+        if(d < directions) return pixel + _offsets[d];
+        if(d == directions) return source();
+        if(d == directions + 1) return sink();
+        return pixel;
+    }
+
+    size_t reverse(size_t arc) const {
+        const auto directions = _directions.size();
+        const auto d = block(arc);
+        const auto pixel = arc % _pixels;
+
+        if(d < directions) return (d ^ 1) * _pixels + pixel + _offsets[d];
+        return (d < directions + 2 ? d + 2 : d - 2) * _pixels + pixel;
+    }
+
+    int& residual(size_t arc) {
+        return _residual[arc];
+    }
+};
+
+template <typename Topology>
+class BoykovKolmogorov {
+private:
+    enum Tree : unsigned char { FREE, SOURCE, SINK };
+
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    static constexpr size_t TERMINAL = NONE - 1;    // parent of the two roots
+    static constexpr size_t ORPHAN = NONE - 2;
+
+    Topology& _graph;
+
+    std::vector<Tree> _tree;
+    std::vector<size_t> _parent;       // arc from the vertex to its parent
+    std::vector<bool> _active;
+    std::deque<size_t> _queue;
+    std::deque<size_t> _orphans;
+
+    // Distance to the root, valid for the vertices stamped with the current time,
+    // keeps the trees shallow when orphans look for a new parent
+    std::vector<size_t> _timestamp;
+    std::vector<size_t> _distance;
+    size_t _time = 0;
+
+    size_t _flow = 0;
+
+private:
+    // Residual capacity of an arc leaving a vertex of `tree` in the direction the tree grows
+    int growth_residual(size_t arc, Tree tree) {
+        return _graph.residual(tree == SOURCE ? arc : _graph.reverse(arc));
+    }
+
+    void activate(size_t vertex) {
+        if(_active[vertex]) return;
+        _active[vertex] = true;
+        _queue.push_back(vertex);
+    }
+
+    void orphan(size_t vertex) {
+        _parent[vertex] = ORPHAN;
+        _orphans.push_back(vertex);
+    }
+
+    // Attaches the free neighbours of a root. The roots are never active: scanning the
+    // arcs of a root again after every augmentation is quadratic on the terminal arcs of
+    // a grid, and a root never gains a residual arc to a vertex that isn't in a tree.
+    void seed(size_t root) {
+        const auto tree = _tree[root];
+        _graph.for_each_arc(root, [&](size_t arc, size_t to) {
+            const auto residual = growth_residual(arc, tree);
+            if(residual == 0) return false;
+
+            if(_parent[to] == TERMINAL && to != root) {    // arc straight between the roots
+                const auto forward = tree == SOURCE ? arc : _graph.reverse(arc);
+                _graph.residual(forward) -= residual;
+                _graph.residual(_graph.reverse(forward)) += residual;
+                _flow += residual;
+                return false;
+            }
+            if(_tree[to] != FREE) return false;
+
+            _tree[to] = tree;
+            _parent[to] = _graph.reverse(arc);
+            _distance[to] = 1;
+            activate(to);
+            return false;
+        });
+    }
+
+    // Arc from the source tree to the sink tree, or NONE once no active vertex is left.
+    // The vertex that found the arc stays at the front of the queue.
+    size_t grow() {
+        while(!_queue.empty()) {
+            const auto from = _queue.front();
+            const auto tree = _tree[from];
+
+            size_t meeting = NONE;
+            if(tree != FREE) {
+                _graph.for_each_arc(from, [&](size_t arc, size_t to) {
+                    if(growth_residual(arc, tree) == 0) return false;
+
+                    if(_tree[to] == FREE) {
+                        _tree[to] = tree;
+                        _parent[to] = _graph.reverse(arc);
+                        _timestamp[to] = _timestamp[from];
+                        _distance[to] = _distance[from] + 1;
+                        activate(to);
+                    } else if(_tree[to] != tree) {
+                        meeting = tree == SOURCE ? arc : _graph.reverse(arc);
+                        return true;
+                    } else if(_timestamp[to] <= _timestamp[from] && _distance[to] > _distance[from] + 1) {
+                        _parent[to] = _graph.reverse(arc);
+                        _timestamp[to] = _timestamp[from];
+                        _distance[to] = _distance[from] + 1;
+                    }
+                    return false;
+                });
+            }
+
+            if(meeting != NONE) return meeting;
+
+            _queue.pop_front();
+            _active[from] = false;
+        }
+        return NONE;
+    }
+
+    void augment(size_t meeting) {
+        const auto first = _graph.head(_graph.reverse(meeting));
+        const auto last = _graph.head(meeting);
+
+        auto flow = _graph.residual(meeting);
+        for(auto v = first; _parent[v] != TERMINAL; v = _graph.head(_parent[v])) {
+            flow = std::min(flow, _graph.residual(_graph.reverse(_parent[v])));
+        }
+        for(auto v = last; _parent[v] != TERMINAL; v = _graph.head(_parent[v])) {
+            flow = std::min(flow, _graph.residual(_parent[v]));
+        }
+
+        _graph.residual(meeting) -= flow;
+        _graph.residual(_graph.reverse(meeting)) += flow;
+
+        for(auto v = first; _parent[v] != TERMINAL; ) {
+            const auto arc = _parent[v];
+            const auto next = _graph.head(arc);
+            _graph.residual(arc) += flow;
+            if((_graph.residual(_graph.reverse(arc)) -= flow) == 0) orphan(v);
+            v = next;
+        }
+        for(auto v = last; _parent[v] != TERMINAL; ) {
+            const auto arc = _parent[v];
+            const auto next = _graph.head(arc);
+            _graph.residual(_graph.reverse(arc)) += flow;
+            if((_graph.residual(arc) -= flow) == 0) orphan(v);
+            v = next;
+        }
+
+        _flow += flow;
+    }
+
+    // Distance from vertex to its root, NONE if its path runs into an orphan
+    size_t origin(size_t vertex) {
+        size_t distance = 0;
+        for(auto v = vertex; ; ) {
+            if(_timestamp[v] == _time) {
+                distance += _distance[v];
+                break;
+            }
+
+            const auto arc = _parent[v];
+            if(arc == ORPHAN) return NONE;
+            if(arc == TERMINAL) {
+                _timestamp[v] = _time;
+                _distance[v] = 0;
+                break;
+            }
+
+            ++distance;
+            v = _graph.head(arc);
+        }
+
+        auto d = distance;
+        for(auto v = vertex; _timestamp[v] != _time; v = _graph.head(_parent[v])) {
+            _timestamp[v] = _time;
+            _distance[v] = d--;
+        }
+        return distance;
+    }
+
+    void adopt(size_t vertex) {
+        const auto tree = _tree[vertex];
+
+        size_t parent = NONE;
+        size_t distance = NONE;
+        _graph.for_each_arc(vertex, [&](size_t arc, size_t to) {
+            if(_tree[to] != tree || growth_residual(_graph.reverse(arc), tree) == 0) return false;
+
+            const auto d = origin(to);
+            if(d < distance) {
+                parent = arc;
+                distance = d;
+            }
+            return false;
+        });
+
+        if(parent != NONE) {
+            _parent[vertex] = parent;
+            _timestamp[vertex] = _time;
+            _distance[vertex] = distance + 1;
+            return;
+        }
+
+        // No valid parent: the vertex leaves its tree, its children become orphans
+        // and the neighbours that could reach it again become active
+        _graph.for_each_arc(vertex, [&](size_t arc, size_t to) {
+            if(_tree[to] != tree) return false;
+
+            if(growth_residual(_graph.reverse(arc), tree) > 0) activate(to);
+            if(_parent[to] != TERMINAL && _parent[to] != ORPHAN && _graph.head(_parent[to]) == vertex) orphan(to);
+            return false;
+        });
+        _tree[vertex] = FREE;
+    }
+
+public:
+    explicit BoykovKolmogorov(Topology& graph) : _graph(graph) {}
+
+    size_t max_flow(size_t from, size_t to) {
+        const auto size = _graph.size();
+        _graph.build();
+
+        _tree.assign(size, FREE);
+        _parent.assign(size, ORPHAN);
+        _active.assign(size, false);
+        _timestamp.assign(size, 0);
+        _distance.assign(size, 0);
+        _queue.clear();
+        _orphans.clear();
+        _time = 0;
+        _flow = 0;
+
+        if(from == to) return 0;
+
+        _tree[from] = SOURCE;
+        _tree[to] = SINK;
+        _parent[from] = _parent[to] = TERMINAL;
+        seed(from);
+        seed(to);
+
+        for(auto meeting = grow(); meeting != NONE; meeting = grow()) {
+            augment(meeting);
+
+            ++_time;
+            while(!_orphans.empty()) {
+                const auto vertex = _orphans.front();
+                _orphans.pop_front();
+                adopt(vertex);
+            }
+        }
+        return _flow;
+    }
+
+    // Side of a vertex in the min cut found by the last max_flow
+    bool source_side(size_t vertex) const {
+        return _tree[vertex] == SOURCE;
+    }
+};
+
+
+int main() {
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 6 },
+        { 0, 2, 14 },
+        { 1, 2, 1 },
+        { 1, 3, 5 },
+        { 2, 3, 7 },
+        { 2, 4, 10 },
+        { 3, 4, 1 },
+        { 3, 5, 11 },
+        { 4, 5, 12 }
+    };
+
+    Graph graph(6);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    BoykovKolmogorov<Graph> solver(graph);
+    std::cout << "Max flow: " << solver.max_flow(0, 5) << std::endl << std::endl;
+
+    for(const auto& edge : edges) {
+        std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
+    }
+
+    // Binary segmentation of a small image: bright pixels prefer the source, dark
+    // ones the sink, and neighbours pay for being separated
+    const std::vector<std::vector<int>> image = {
+        { 9, 8, 2, 1, 1 },
+        { 9, 9, 3, 1, 0 },
+        { 8, 7, 8, 2, 1 },
+        { 9, 8, 6, 1, 2 }
+    };
+
+    GridGraph grid(5, 4, 1, GridGraph::Neighbourhood::Four);
+    for(size_t y = 0; y < 4; ++y) {
+        for(size_t x = 0; x < 5; ++x) {
+            const auto pixel = grid.pixel(x, y);
+            grid.set_terminals(pixel, image[y][x], 9 - image[y][x]);
+            for(size_t d = 0; d < grid.directions(); ++d) {
+                grid.set_capacity(pixel, d, 2);
+            }
+        }
+    }
+
+    BoykovKolmogorov<GridGraph> segmentation(grid);
+    std::cout << std::endl << "Segmentation cut: " << segmentation.max_flow(grid.source(), grid.sink()) << std::endl;
+    for(size_t y = 0; y < 4; ++y) {
+        for(size_t x = 0; x < 5; ++x) {
+            std::cout << (segmentation.source_side(grid.pixel(x, y)) ? '#' : '.');
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,794 @@
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <stdexcept>
+#include <charconv>
+#include <cstring>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+
+public:
+    explicit MappedFile(const std::string& path) {
+        const auto fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) throw std::runtime_error("cannot open " + path);
+
+        struct stat info;
+        if(::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+
+        _size = info.st_size;
+        if(_size > 0) {
+            auto* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path);
+            }
+            ::madvise(data, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if(_data) ::munmap(const_cast<char*>(_data), _size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const { return _data; }
+    const char* end() const { return _data + _size; }
+    size_t size() const { return _size; }
+};
+
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+    };
+
+    size_t _size;
+    std::vector<Edge> _edges;
+    bool _built = false;
+
+    // CSR residual graph: arcs of vertex v are [_offsets[v], _offsets[v + 1]),
+    // every edge owns a forward arc and a paired reverse arc (_reverse[arc]).
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<int> _residual;
+    std::vector<int> _capacity;      // residual of every arc before any flow, shared by batch queries
+    std::vector<size_t> _forward;    // forward arc of every edge
+
+    size_t _flow_value = 0;
+    size_t _augmentations = 0;
+    size_t _source = 0;
+    size_t _sink = 0;
+
+    std::vector<int> _levels;
+    std::vector<size_t> _current;    // current-arc pointers
+
+    // Dinic for one batch query: the base capacities stay read-only in the graph and the
+    // query only stores the net flow of the arcs it touched, residual = capacity - flow.
+    struct Query {
+        const Graph& graph;
+        std::unordered_map<size_t, int> flow;
+        std::vector<int> levels;
+        std::vector<size_t> current;
+        std::vector<size_t> queue;
+
+        explicit Query(const Graph& graph) : graph(graph), levels(graph._size), current(graph._size) {}
+
+        int residual(size_t arc) const {
+            const auto it = flow.find(arc);
+            return graph._capacity[arc] - (it == flow.end() ? 0 : it->second);
+        }
+
+        void push(size_t arc, int amount) {
+            if((flow[arc] += amount) == 0) flow.erase(arc);
+            if((flow[ graph._reverse[arc] ] -= amount) == 0) flow.erase(graph._reverse[arc]);
+        }
+
+        bool bfs(size_t start, size_t finish) {
+            levels.assign(graph._size, -1);
+            levels[start] = 0;
+
+            queue.assign(1, start);
+            for(size_t i = 0; i < queue.size(); ++i) {
+                const auto from = queue[i];
+                for(auto arc = graph._offsets[from]; arc < graph._offsets[from + 1]; ++arc) {
+                    const auto to = graph._heads[arc];
+                    if(levels[to] != -1 || residual(arc) == 0) continue;
+
+                    levels[to] = levels[from] + 1;
+                    queue.push_back(to);
+                }
+            }
+            return levels[finish] != -1;
+        }
+
+        size_t blocking_flow(size_t start, size_t finish) {
+            for(size_t v = 0; v < graph._size; ++v) {
+                current[v] = graph._offsets[v];
+            }
+
+            size_t total_flow = 0;
+            std::vector<size_t> path;
+            auto from = start;
+
+            while(true) {
+                if(from == finish) {
+                    int amount = std::numeric_limits<int>::max();
+                    for(const auto arc : path) {
+                        amount = std::min(amount, residual(arc));
+                    }
+
+                    size_t saturated = path.size();
+                    for(size_t i = 0; i < path.size(); ++i) {
+                        push(path[i], amount);
+                        if(saturated == path.size() && residual(path[i]) == 0) saturated = i;
+                    }
+                    total_flow += amount;
+
+                    path.resize(saturated);
+                    from = path.empty() ? start : graph._heads[path.back()];
+                    continue;
+                }
+
+                auto& arc = current[from];
+                while(arc < graph._offsets[from + 1] && (levels[ graph._heads[arc] ] != levels[from] + 1 || residual(arc) == 0)) {
+                    ++arc;
+                }
+
+                if(arc < graph._offsets[from + 1]) {
+                    path.push_back(arc);
+                    from = graph._heads[arc];
+                    continue;
+                }
+
+                levels[from] = -1;
+                if(path.empty()) break;
+
+                path.pop_back();
+                from = path.empty() ? start : graph._heads[path.back()];
+                ++current[from];
+            }
+            return total_flow;
+        }
+
+        size_t max_flow(size_t start, size_t finish) {
+            flow.clear();
+            if(start == finish) return 0;
+
+            size_t total_flow = 0;
+            while(bfs(start, finish)) {
+                total_flow += blocking_flow(start, finish);
+            }
+            return total_flow;
+        }
+    };
+
+private:
+    void build() {
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+        _capacity.resize(arcs);
+        _forward.resize(_edges.size());
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(size_t i = 0; i < _edges.size(); ++i) {
+            const auto& edge = _edges[i];
+            const auto forward = position[edge.from]++;
+            const auto backward = position[edge.to]++;
+
+            _heads[forward] = edge.to;
+            _reverse[forward] = backward;
+            _residual[forward] = edge.capacity;
+
+            _heads[backward] = edge.from;
+            _reverse[backward] = forward;
+            _residual[backward] = 0;
+
+            _forward[i] = forward;
+        }
+        _capacity = _residual;
+
+        _flow_value = 0;
+        _levels.resize(_size);
+        _current.resize(_size);
+        _built = true;
+    }
+
+    bool bfs(size_t start, size_t finish) {
+        _levels.assign(_size, -1);
+        _levels[start] = 0;
+
+        std::queue<size_t> queue;
+        queue.push(start);
+
+        while(!queue.empty()) {
+            const auto from = queue.front();
+            queue.pop();
+
+            for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+                const auto to = _heads[arc];
+                if(_residual[arc] == 0 || _levels[to] != -1) continue;
+
+                _levels[to] = _levels[from] + 1;
+                queue.push(to);
+            }
+        }
+
+        return _levels[finish] != -1;
+    }
+
+    // Blocking flow on the level graph, the DFS keeps an explicit stack of arcs.
+    size_t blocking_flow(size_t start, size_t finish) {
+        for(size_t v = 0; v < _size; ++v) {
+            _current[v] = _offsets[v];
+        }
+
+        size_t total_flow = 0;
+        std::vector<size_t> path;
+        auto from = start;
+
+        while(true) {
+            if(from == finish) {
+                int flow = std::numeric_limits<int>::max();
+                for(const auto arc : path) {
+                    flow = std::min(flow, _residual[arc]);
+                }
+
+                size_t saturated = path.size();
+                for(size_t i = 0; i < path.size(); ++i) {
+                    _residual[ path[i] ] -= flow;
+                    _residual[ _reverse[path[i]] ] += flow;
+                    if(_residual[ path[i] ] == 0 && saturated == path.size()) {
+                        saturated = i;
+                    }
+                }
+                total_flow += flow;
+                ++_augmentations;
+
+                path.resize(saturated);
+                from = path.empty() ? start : _heads[path.back()];
+                continue;
+            }
+
+            auto& arc = _current[from];
+            while(arc < _offsets[from + 1] && (_residual[arc] == 0 || _levels[ _heads[arc] ] != _levels[from] + 1)) {
+                ++arc;
+            }
+
+            if(arc < _offsets[from + 1]) {
+                path.push_back(arc);
+                from = _heads[arc];
+                continue;
+            }
+
+            // Dead end: drop the vertex from the level graph and retreat
+            _levels[from] = -1;
+            if(path.empty()) break;
+
+            path.pop_back();
+            from = path.empty() ? start : _heads[path.back()];
+            ++_current[from];
+        }
+
+        return total_flow;
+    }
+
+public:
+    explicit Graph(size_t size) : _size(size) {}
+
+    // Adding edges after a solve rebuilds the residual graph from scratch.
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+        _built = false;
+    }
+
+    size_t max_flow(size_t from, size_t to) {
+        if(!_built) build();
+        _source = from;
+        _sink = to;
+
+        size_t total_flow = 0;
+        while(bfs(from, to)) {
+            total_flow += blocking_flow(from, to);
+        }
+        _flow_value += total_flow;
+        return total_flow;
+    }
+
+    // Residual capacity from -> to, summed over parallel and reverse arcs as in the matrix graphs
+    int get_capacity(size_t from, size_t to) {
+        if(!_built) build();
+
+        int capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
+    }
+
+    size_t augmentations() const {
+        return _augmentations;
+    }
+
+    // Flow on an edge, edges are numbered in add_edge order
+    int flow(size_t edge) {
+        if(!_built) build();
+        return _edges[edge].capacity - _residual[ _forward[edge] ];
+    }
+
+    // Vertices reachable from the source of the last max_flow in the residual graph,
+    // the source side of a minimum cut. O(V + E)
+    std::vector<bool> min_cut_side() {
+        if(!_built) build();
+
+        std::vector<bool> side(_size, false);
+        std::vector<size_t> stack(1, _source);
+        side[_source] = true;
+
+        while(!stack.empty()) {
+            const auto from = stack.back();
+            stack.pop_back();
+
+            for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+                const auto to = _heads[arc];
+                if(_residual[arc] == 0 || side[to]) continue;
+
+                side[to] = true;
+                stack.push_back(to);
+            }
+        }
+        return side;
+    }
+
+    // Edges leaving the source side of the minimum cut, all of them saturated
+    std::vector<size_t> min_cut_edges() {
+        const auto side = min_cut_side();
+
+        std::vector<size_t> edges;
+        for(size_t i = 0; i < _edges.size(); ++i) {
+            if(side[ _edges[i].from ] && !side[ _edges[i].to ]) edges.push_back(i);
+        }
+        return edges;
+    }
+
+    struct Path {
+        std::vector<size_t> vertices;    // source to sink
+        std::vector<size_t> edges;       // in add_edge numbering
+        int flow;
+    };
+
+    // Source to sink paths the flow of the last max_flow decomposes into, produced one
+    // at a time so only O(E) state is kept. The walk follows edges that still carry flow
+    // with current-edge pointers and cancels the cycles it closes, which carry no s-t
+    // flow; every path empties an edge, so there are at most E of them.
+    class FlowPaths {
+    private:
+        const Graph& _graph;
+        std::vector<int> _remaining;     // flow not yet assigned to a path, per arc
+        std::vector<size_t> _edge;       // edge of every forward arc, NONE for reverse arcs
+        std::vector<size_t> _current;
+        std::vector<size_t> _position;   // index of a vertex in the walk, NONE if not on it
+        std::vector<size_t> _walk;       // arcs from the source
+
+        static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+        size_t tail(size_t arc) const {
+            return _graph._heads[ _graph._reverse[arc] ];
+        }
+
+        // Drops the walk back to the vertex at `position`
+        void truncate(size_t position) {
+            while(_walk.size() > position) {
+                _position[ _graph._heads[_walk.back()] ] = NONE;
+                _walk.pop_back();
+            }
+        }
+
+    public:
+        explicit FlowPaths(const Graph& graph)
+            : _graph(graph), _remaining(graph._offsets[graph._size], 0), _edge(graph._offsets[graph._size], NONE),
+              _current(graph._offsets.begin(), graph._offsets.end() - 1), _position(graph._size, NONE) {
+            for(size_t i = 0; i < graph._edges.size(); ++i) {
+                const auto arc = graph._forward[i];
+                _edge[arc] = i;
+                _remaining[arc] = graph._edges[i].capacity - graph._residual[arc];
+            }
+            _position[graph._source] = 0;
+        }
+
+        // Next path, false once the flow is used up
+        bool next(Path& path) {
+            const auto source = _graph._source;
+            const auto sink = _graph._sink;
+            if(source == sink) return false;
+
+            while(true) {
+                const auto from = _walk.empty() ? source : _graph._heads[_walk.back()];
+
+                if(from == sink) {
+                    path.flow = std::numeric_limits<int>::max();
+                    for(const auto arc : _walk) {
+                        path.flow = std::min(path.flow, _remaining[arc]);
+                    }
+
+                    path.vertices.assign(1, source);
+                    path.edges.clear();
+                    for(const auto arc : _walk) {
+                        _remaining[arc] -= path.flow;
+                        path.vertices.push_back(_graph._heads[arc]);
+                        path.edges.push_back(_edge[arc]);
+                    }
+
+                    truncate(0);
+                    return true;
+                }
+
+                auto& arc = _current[from];
+                while(arc < _graph._offsets[from + 1] && (_edge[arc] == NONE || _remaining[arc] == 0)) {
+                    ++arc;
+                }
+
+                // Flow is conserved, so only the source runs out of outgoing flow
+                if(arc == _graph._offsets[from + 1]) return false;
+
+                const auto to = _graph._heads[arc];
+                if(_position[to] == NONE) {
+                    _position[to] = _walk.size() + 1;
+                    _walk.push_back(arc);
+                    continue;
+                }
+
+                // The walk closed a cycle through `to`: cancel it and resume from there
+                auto flow = _remaining[arc];
+                for(auto i = _position[to]; i < _walk.size(); ++i) {
+                    flow = std::min(flow, _remaining[ _walk[i] ]);
+                }
+                _remaining[arc] -= flow;
+                for(auto i = _position[to]; i < _walk.size(); ++i) {
+                    _remaining[ _walk[i] ] -= flow;
+                }
+                truncate(_position[to]);
+            }
+        }
+
+        class iterator {
+        private:
+            FlowPaths* _paths;
+            Path _path;
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Path;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Path*;
+            using reference = const Path&;
+
+            explicit iterator(FlowPaths* paths) : _paths(paths) {
+                if(_paths && !_paths->next(_path)) _paths = nullptr;
+            }
+
+            const Path& operator*() const { return _path; }
+            const Path* operator->() const { return &_path; }
+
+            iterator& operator++() {
+                if(!_paths->next(_path)) _paths = nullptr;
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const { return _paths == other._paths; }
+            bool operator!=(const iterator& other) const { return _paths != other._paths; }
+        };
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(nullptr); }
+    };
+
+    FlowPaths flow_paths() {
+        if(!_built) build();
+        return FlowPaths(*this);
+    }
+
+    // Independent max flows of many (source, sink) pairs on the original capacities,
+    // answered by `threads` workers without touching the residual graph of max_flow.
+    // threads == 0 picks std::thread::hardware_concurrency()
+    std::vector<size_t> max_flows(const std::vector<std::pair<size_t, size_t>>& queries, size_t threads = 0) {
+        if(!_built) build();
+        if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<size_t> flows(queries.size());
+        std::atomic<size_t> next(0);
+        auto work = [&] {
+            Query query(*this);
+            for(auto i = next.fetch_add(1); i < queries.size(); i = next.fetch_add(1)) {
+                flows[i] = query.max_flow(queries[i].first, queries[i].second);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for(size_t thread = 1; thread < std::min(threads, queries.size()); ++thread) {
+            workers.emplace_back(work);
+        }
+        work();
+        for(auto& worker : workers) worker.join();
+
+        return flows;
+    }
+
+    // DIMACS max-flow problem ("p max n m", "n id s|t", "a from to capacity").
+    // The file is memory mapped and parsed by `threads` workers over line-aligned
+    // chunks: a first pass counts arc lines, a second one writes every arc straight
+    // into its slot of the edge array the CSR graph is built from.
+    static Graph load_dimacs(const std::string& path, size_t& source, size_t& sink, size_t threads = 0) {
+        if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const MappedFile file(path);
+        const auto npos = std::numeric_limits<size_t>::max();
+
+        struct Chunk {
+            const char* begin;
+            const char* end;
+            size_t arcs = 0;
+            size_t vertices = 0;
+            bool problem = false;
+            size_t source = std::numeric_limits<size_t>::max();
+            size_t sink = std::numeric_limits<size_t>::max();
+            const char* error = nullptr;
+        };
+
+        std::vector<Chunk> chunks(std::min(threads, std::max<size_t>(1, file.size() / (1 << 16))));
+        for(size_t i = 0; i < chunks.size(); ++i) {
+            auto begin = file.begin() + file.size() * i / chunks.size();
+            if(i > 0) begin = next_line(begin - 1, file.end());
+            chunks[i].begin = begin;
+            if(i > 0) chunks[i - 1].end = begin;
+        }
+        chunks.back().end = file.end();
+
+        auto parallel = [&](auto body) {
+            std::vector<std::thread> workers;
+            for(size_t i = 1; i < chunks.size(); ++i) workers.emplace_back(body, std::ref(chunks[i]));
+            body(chunks[0]);
+            for(auto& worker : workers) worker.join();
+        };
+
+        parallel([](Chunk& chunk) {
+            for(auto it = chunk.begin; it < chunk.end && !chunk.error; it = next_line(it, chunk.end)) {
+                size_t id = 0;
+                switch(*it) {
+                case 'a':
+                    ++chunk.arcs;
+                    break;
+                case 'p': {
+                    auto field = skip_blanks(it + 1, chunk.end);
+                    while(field < chunk.end && *field != ' ' && *field != '\t') ++field;    // "max"
+                    size_t edges = 0;
+                    field = scan(field, chunk.end, chunk.vertices);
+                    if(!field || !scan(field, chunk.end, edges)) chunk.error = it;
+                    chunk.problem = true;
+                    break;
+                }
+                case 'n': {
+                    auto field = scan(it + 1, chunk.end, id);
+                    field = field ? skip_blanks(field, chunk.end) : nullptr;
+                    if(!field || field == chunk.end || (*field != 's' && *field != 't') || id == 0) {
+                        chunk.error = it;
+                        break;
+                    }
+                    (*field == 's' ? chunk.source : chunk.sink) = id - 1;
+                    break;
+                }
+                case 'c': case '\n': case '\r':
+                    break;
+                default:
+                    chunk.error = it;
+                }
+            }
+        });
+
+        size_t vertices = 0;
+        size_t arcs = 0;
+        source = sink = npos;
+        bool problem = false;
+        for(const auto& chunk : chunks) {
+            if(chunk.error) throw std::runtime_error("malformed DIMACS line at offset " + std::to_string(chunk.error - file.begin()));
+            if(chunk.problem) vertices = chunk.vertices;
+            if(chunk.source != npos) source = chunk.source;
+            if(chunk.sink != npos) sink = chunk.sink;
+            problem = problem || chunk.problem;
+            arcs += chunk.arcs;
+        }
+        if(!problem || source >= vertices || sink >= vertices) {
+            throw std::runtime_error("DIMACS file without a valid problem, source or sink line");
+        }
+
+        Graph graph(vertices);
+        graph._edges.resize(arcs);
+
+        std::vector<size_t> offsets(chunks.size(), 0);
+        for(size_t i = 1; i < chunks.size(); ++i) {
+            offsets[i] = offsets[i - 1] + chunks[i - 1].arcs;
+        }
+
+        parallel([&](Chunk& chunk) {
+            auto* edge = graph._edges.data() + offsets[&chunk - chunks.data()];
+            for(auto it = chunk.begin; it < chunk.end && !chunk.error; it = next_line(it, chunk.end)) {
+                if(*it != 'a') continue;
+
+                size_t from = 0, to = 0, capacity = 0;
+                auto field = scan(it + 1, chunk.end, from);
+                field = field ? scan(field, chunk.end, to) : nullptr;
+                field = field ? scan(field, chunk.end, capacity) : nullptr;
+                if(!field || from == 0 || to == 0 || from > vertices || to > vertices
+                   || capacity > static_cast<size_t>(std::numeric_limits<int>::max())) {
+                    chunk.error = it;
+                    break;
+                }
+
+                *edge++ = { from - 1, to - 1, static_cast<int>(capacity) };
+            }
+        });
+
+        for(const auto& chunk : chunks) {
+            if(chunk.error) throw std::runtime_error("malformed DIMACS arc at offset " + std::to_string(chunk.error - file.begin()));
+        }
+        return graph;
+    }
+
+    // DIMACS solution: "s flow" and one "f from to flow" line per arc in input order
+    void write_dimacs_flow(const std::string& path) {
+        if(!_built) build();
+
+        std::ofstream out(path, std::ios::binary);
+        if(!out) throw std::runtime_error("cannot write " + path);
+
+        std::string buffer;
+        buffer.reserve(1 << 20);
+
+        auto append = [&](size_t value) {
+            char digits[24];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer.append(digits, result.ptr);
+        };
+
+        buffer += "s ";
+        append(_flow_value);
+        buffer += '\n';
+
+        for(size_t i = 0; i < _edges.size(); ++i) {
+            buffer += "f ";
+            append(_edges[i].from + 1);
+            buffer += ' ';
+            append(_edges[i].to + 1);
+            buffer += ' ';
+            append(_edges[i].capacity - _residual[ _forward[i] ]);
+            buffer += '\n';
+
+            if(buffer.size() > (1 << 20) - 64) {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+private:
+    static const char* next_line(const char* it, const char* end) {
+        const auto* newline = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        return newline ? newline + 1 : end;
+    }
+
+    static const char* skip_blanks(const char* it, const char* end) {
+        while(it < end && (*it == ' ' || *it == '\t')) ++it;
+        return it;
+    }
+
+    // Unsigned integer after optional blanks, nullptr if there is none
+    static const char* scan(const char* it, const char* end, size_t& value) {
+        it = skip_blanks(it, end);
+        if(it == end || *it < '0' || *it > '9') return nullptr;
+
+        value = 0;
+        for(; it < end && *it >= '0' && *it <= '9'; ++it) {
+            value = value * 10 + (*it - '0');
+        }
+        return it;
+    }
+};
+
+
+#ifndef MAX_FLOW_BENCHMARK
+int main(int argc, char** argv) {
+    if(argc > 1) {    // dinic problem.max [solution.flow]
+        size_t source = 0, sink = 0;
+        auto graph = Graph::load_dimacs(argv[1], source, sink);
+
+        std::cout << "Max flow: " << graph.max_flow(source, sink) << std::endl;
+        if(argc > 2) graph.write_dimacs_flow(argv[2]);
+        return 0;
+    }
+
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 6 },
+        { 0, 2, 14 },
+        { 1, 2, 1 },
+        { 1, 3, 5 },
+        { 2, 3, 7 },
+        { 2, 4, 10 },
+        { 3, 4, 1 },
+        { 3, 5, 11 },
+        { 4, 5, 12 }
+    };
+
+    Graph graph(6);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    std::cout << "Max flow: " << graph.max_flow(0, 5) << std::endl << std::endl;
+
+    for(size_t i = 0; i < edges.size(); ++i) {
+        std::cout << "Flow from " << edges[i][0] << " to " << edges[i][1] << ": " << graph.flow(i) << std::endl;
+    }
+
+    std::cout << std::endl << "Min cut edges:";
+    for(const auto edge : graph.min_cut_edges()) {
+        std::cout << " " << edges[edge][0] << "->" << edges[edge][1];
+    }
+    std::cout << std::endl << std::endl;
+
+    for(const auto& path : graph.flow_paths()) {
+        std::cout << "Path";
+        for(const auto v : path.vertices) {
+            std::cout << " " << v;
+        }
+        std::cout << ": " << path.flow << std::endl;
+    }
+
+    const std::vector<std::pair<size_t, size_t>> queries = { { 0, 5 }, { 0, 3 }, { 1, 5 }, { 2, 4 }, { 5, 0 } };
+    const auto flows = graph.max_flows(queries);
+
+    std::cout << std::endl;
+    for(size_t i = 0; i < queries.size(); ++i) {
+        std::cout << "Max flow " << queries[i].first << " -> " << queries[i].second << ": " << flows[i] << std::endl;
+    }
+
+    return 0;
+}
+#endif
@@ -2,17 +2,142 @@
 #include <queue>
 #include <iostream>
 #include <limits>
+#include <cstdint>
 
 class Graph {
 private:
-    std::vector<std::vector<int>> _graph;
+    std::vector<std::vector<int>> _graph;       // residual capacities
+    std::vector<std::vector<int>> _capacity;
+
+    // Last solved pair, its residual graph stays in _graph for incremental re-solves
+    size_t _source = 0;
+    size_t _sink = 0;
+    bool _solved = false;
+    size_t _total_flow = 0;
+    size_t _augmentations = 0;
+
+    // Dense mode: bit v of row u in _nonzero is set while _graph[u][v] > 0,
+    // _nonzero_transposed holds the same bits by column
+    using Word = std::uint64_t;
+    static constexpr size_t BITS = 64;
+
+    bool _dense;
+    size_t _words;
+    std::vector<Word> _nonzero;
+    std::vector<Word> _nonzero_transposed;
 
 private:
+    void set_bit(std::vector<Word>& bits, size_t row, size_t column, bool value) {
+        auto& word = bits[row * _words + column / BITS];
+        const auto mask = Word(1) << (column % BITS);
+        word = value ? (word | mask) : (word & ~mask);
+    }
+
+    void update_bits(size_t from, size_t to) {
+        if(!_dense) return;
+
+        set_bit(_nonzero, from, to, _graph[from][to] > 0);
+        set_bit(_nonzero_transposed, to, from, _graph[from][to] > 0);
+    }
+
+    void rebuild_bits() {
+        if(!_dense) return;
+
+        for(size_t from = 0; from < _graph.size(); ++from) {
+            for(size_t to = 0; to < _graph.size(); ++to) {
+                update_bits(from, to);
+            }
+        }
+    }
+
+    void push(size_t from, size_t to, int flow) {
+        _graph[from][to] -= flow;
+        _graph[to][from] += flow;
+
+        update_bits(from, to);
+        update_bits(to, from);
+    }
+
+    // Direction-optimizing BFS over the bitsets: a top-down step expands every frontier
+    // row with AND NOT visited, a bottom-up step looks for any frontier vertex in the
+    // column of every unvisited vertex. The step is picked by frontier vs unvisited size.
+    size_t dense_bfs(size_t start, size_t finish, std::vector<int>& parents) {
+        std::vector<Word> visited(_words, 0);
+        std::vector<Word> frontier(_words, 0);
+        std::vector<Word> next(_words, 0);
+
+        auto mark = [](std::vector<Word>& bits, size_t v) { bits[v / BITS] |= Word(1) << (v % BITS); };
+        auto found = [&] { return (visited[finish / BITS] >> (finish % BITS)) & 1; };
+
+        mark(visited, start);
+        mark(frontier, start);
+        size_t frontier_size = 1;
+        size_t unvisited_size = _graph.size() - 1;
+
+        while(frontier_size > 0 && !found()) {
+            std::fill(next.begin(), next.end(), 0);
+
+            if(4 * frontier_size < unvisited_size) {
+                for(size_t word = 0; word < _words; ++word) {
+                    for(auto bits = frontier[word]; bits; bits &= bits - 1) {
+                        const auto from = word * BITS + __builtin_ctzll(bits);
+                        const auto* row = _nonzero.data() + from * _words;
+
+                        for(size_t i = 0; i < _words; ++i) {
+                            auto candidates = row[i] & ~visited[i];
+                            visited[i] |= candidates;
+                            next[i] |= candidates;
+
+                            for(; candidates; candidates &= candidates - 1) {
+                                parents[ i * BITS + __builtin_ctzll(candidates) ] = from;
+                            }
+                        }
+                    }
+                }
+            } else {
+                for(size_t word = 0; word < _words; ++word) {
+                    auto unvisited = ~visited[word];
+                    if(word == _words - 1 && _graph.size() % BITS) unvisited &= (Word(1) << (_graph.size() % BITS)) - 1;
+
+                    for(; unvisited; unvisited &= unvisited - 1) {
+                        const auto to = word * BITS + __builtin_ctzll(unvisited);
+                        const auto* column = _nonzero_transposed.data() + to * _words;
+
+                        for(size_t i = 0; i < _words; ++i) {
+                            if(const auto candidates = column[i] & frontier[i]) {
+                                parents[to] = i * BITS + __builtin_ctzll(candidates);
+                                mark(next, to);
+                                break;
+                            }
+                        }
+                    }
+                }
+                for(size_t i = 0; i < _words; ++i) visited[i] |= next[i];
+            }
+
+            frontier.swap(next);
+            frontier_size = 0;
+            for(const auto word : frontier) frontier_size += __builtin_popcountll(word);
+            unvisited_size -= frontier_size;
+        }
+
+        if(!found()) return 0;
+
+        int flow = std::numeric_limits<int>::max();
+        for(size_t it = finish; it != start; it = parents[it]) {
+            flow = std::min(flow, _graph[ parents[it] ][ it ]);
+        }
+        return flow;
+    }
+
     size_t bfs(size_t start, size_t finish, std::vector<int>& parents) {
+        if(_dense) return dense_bfs(start, finish, parents);
+
         std::queue<std::pair<size_t, int>> queue;    // <vertex, flow>
         queue.emplace(start, std::numeric_limits<int>::max());
 
         std::vector<bool> visited(_graph.size(), false);
+        visited[start] = true;
 
         while(!queue.empty()) {
             const auto from = queue.front().first;
@@ -20,13 +145,11 @@ private:
             queue.pop();
 
             if(from == finish) return flow;
-            if(visited[from]) continue;
-
-            visited[from] = true;
 
             for(size_t to = 0; to < _graph[from].size(); ++to) {
-                if(visited[to] || (_graph[from][to] == 0)) continue;
+                if(visited[to] || (_graph[from][to] <= 0)) continue;
 
+                visited[to] = true;
                 queue.emplace(to, std::min(flow, _graph[from][to]));
                 parents[to] = from;
             }
@@ -35,41 +158,119 @@ private:
         return 0;
     }
 
+    // Pushes up to limit units along one shortest residual path, returns the amount pushed
+    int augment(size_t from, size_t to, int limit) {
+        std::vector<int> parents(_graph.size(), -1);
+
+        const auto flow = std::min<int>(limit, bfs(from, to, parents));
+        if(flow == 0) return 0;
+
+        ++_augmentations;
+        for(auto it = to; it != from; it = parents[it]) {
+            push(parents[it], it, flow);
+        }
+        return flow;
+    }
+
+    // The edge from -> to carries overflow units more than its capacity. Cancel them on
+    // the edge, reroute what we can around it and return the rest to the source.
+    void repair(size_t from, size_t to, int overflow) {
+        push(from, to, -overflow);
+
+        while(overflow > 0) {
+            const auto flow = augment(from, to, overflow);
+            if(flow == 0) break;
+            overflow -= flow;
+        }
+
+        // Excess left at `from` goes back to the source, the deficit at `to` is taken from the sink
+        auto excess = overflow;
+        while(excess > 0 && from != _source && from != _sink) {
+            const auto flow = augment(from, _source, excess);
+            if(flow == 0) break;
+            excess -= flow;
+        }
+        auto deficit = overflow;
+        while(deficit > 0 && to != _source && to != _sink) {
+            const auto flow = augment(_sink, to, deficit);
+            if(flow == 0) break;
+            deficit -= flow;
+        }
+
+        _total_flow = 0;
+        for(size_t v = 0; v < _graph.size(); ++v) {
+            _total_flow += _capacity[_source][v] - _graph[_source][v];
+        }
+    }
+
 public:
-    explicit Graph(size_t size) {
+    // dense switches path searches to the bitset BFS
+    explicit Graph(size_t size, bool dense = false) : _dense(dense), _words((size + BITS - 1) / BITS) {
         _graph.resize(size, std::vector<int>(size));
+        _capacity.resize(size, std::vector<int>(size));
+
+        if(_dense) {
+            _nonzero.assign(size * _words, 0);
+            _nonzero_transposed.assign(size * _words, 0);
+        }
     }
 
     void add_edge(size_t from, size_t to, int capacity) {
         _graph[from][to] += capacity;
+        _capacity[from][to] += capacity;
+        update_bits(from, to);
+    }
+
+    // Capacity increases only widen the residual graph, decreases below the current
+    // flow are repaired locally. The next max_flow call resumes from the kept flow.
+    void set_capacity(size_t from, size_t to, int capacity) {
+        _graph[from][to] += capacity - _capacity[from][to];
+        _capacity[from][to] = capacity;
+        update_bits(from, to);
+
+        if(_solved && _graph[from][to] < 0) {
+            repair(from, to, -_graph[from][to]);
+        }
     }
 
     size_t max_flow(size_t from, size_t to) {
-        size_t total_flow = 0;
+        if(!_solved || from != _source || to != _sink) {
+            _graph = _capacity;
+            rebuild_bits();
+            _source = from;
+            _sink = to;
+            _solved = true;
+            _total_flow = 0;
+        }
+
         std::vector<int> parents(_graph.size(), -1);
 
         while(auto flow = bfs(from, to, parents)) {
-            total_flow += flow;
+            _total_flow += flow;
+            ++_augmentations;
 
             auto it = to;
             while(it != from) {
-                _graph[ parents[it] ][ it ] -= flow;
-                _graph[ it ][ parents[it] ] += flow;
-
+                push(parents[it], it, flow);
                 it = parents[it];
             }
 
             parents.assign(parents.size(), -1);
         }
-        return total_flow;
+        return _total_flow;
     }
 
     int get_capacity(size_t from, size_t to) {
         return _graph[from][to];
     }
+
+    size_t augmentations() const {
+        return _augmentations;
+    }
 };
 
 
+#ifndef MAX_FLOW_BENCHMARK
 int main() {
     std::vector<std::vector<size_t>> edges = {
         { 0, 1, 6 },
@@ -94,5 +295,12 @@ int main() {
         std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
     }
 
+    graph.add_edge(1, 5, 4);
+    std::cout << std::endl << "Max flow after adding 1 -> 5: " << graph.max_flow(0, 5) << std::endl;
+
+    graph.set_capacity(2, 4, 2);
+    std::cout << "Max flow after lowering 2 -> 4 to 2: " << graph.max_flow(0, 5) << std::endl;
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
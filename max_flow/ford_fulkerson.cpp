@@ -1,56 +1,373 @@
 #include <vector>
 #include <iostream>
 #include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 
+template <typename Capacity>
 class Graph {
+public:
+    // Sum of capacities, wide enough not to wrap for 32-bit capacities
+    using Flow = std::common_type_t<Capacity, long long>;
+
+    // State of an anytime solve after a slice: the flow in the graph is always feasible,
+    // upper_bound is the smallest cut capacity seen so far
+    struct Progress {
+        Flow flow;
+        Flow upper_bound;
+        size_t augmentations;
+        bool optimal;
+    };
+
 private:
-    std::vector<std::vector<int>> _graph;
+    std::vector<std::vector<Capacity>> _graph;
+    size_t _augmentations = 0;
 
 private:
-    size_t dfs(size_t from, size_t finish, std::vector<bool>& visited, int flow) {
-        if(visited[from]) return 0;
-        if(from == finish) return flow;
-
-        visited[from] = true;
-
-        for(size_t to = 0; to < _graph[from].size(); ++to) {
-            if(_graph[from][to] == 0) continue;
-            if(auto augmented_flow = dfs(to, finish, visited, std::min(flow, _graph[from][to]))) {
-                _graph[from][to] -= augmented_flow;
-                _graph[to][from] += augmented_flow;
-                return augmented_flow;
+    static bool positive(Capacity capacity) {
+        if constexpr(std::is_floating_point_v<Capacity>) {
+            return capacity > std::numeric_limits<Capacity>::epsilon();
+        } else {
+            return capacity > 0;
+        }
+    }
+
+    // Iterative DFS over residual arcs of at least threshold, augments the path it finds
+    Capacity dfs(size_t start, size_t finish, std::vector<bool>& visited, Capacity threshold) {
+        std::vector<std::pair<size_t, size_t>> stack;     // <vertex, next candidate>
+        stack.emplace_back(start, 0);
+        visited[start] = true;
+
+        while(!stack.empty() && stack.back().first != finish) {
+            const auto from = stack.back().first;
+            auto& to = stack.back().second;
+
+            while(to < _graph.size() && (visited[to] || !positive(_graph[from][to]) || _graph[from][to] < threshold)) {
+                ++to;
+            }
+
+            if(to == _graph.size()) {
+                stack.pop_back();
+                continue;
+            }
+
+            const auto next = to++;
+            visited[next] = true;
+            stack.emplace_back(next, 0);
+        }
+
+        if(stack.empty()) return 0;
+
+        auto flow = std::numeric_limits<Capacity>::max();
+        for(size_t i = 0; i + 1 < stack.size(); ++i) {
+            flow = std::min(flow, _graph[ stack[i].first ][ stack[i + 1].first ]);
+        }
+        for(size_t i = 0; i + 1 < stack.size(); ++i) {
+            _graph[ stack[i].first ][ stack[i + 1].first ] -= flow;
+            _graph[ stack[i + 1].first ][ stack[i].first ] += flow;
+        }
+        return flow;
+    }
+
+    // Thresholds of the capacity scaling phases, ending with 0 for the exact last phase
+    std::vector<Capacity> thresholds() const {
+        Capacity largest = 0;
+        for(const auto& row : _graph) {
+            for(const auto capacity : row) largest = std::max(largest, capacity);
+        }
+
+        Capacity delta = 1;
+        while(delta <= largest / 2) delta *= 2;
+
+        std::vector<Capacity> result;
+        if constexpr(std::is_floating_point_v<Capacity>) {
+            for(; delta > largest * std::numeric_limits<Capacity>::epsilon(); delta /= 2) result.push_back(delta);
+        } else {
+            for(; delta > 0; delta /= 2) result.push_back(delta);
+        }
+        result.push_back(0);
+        return result;
+    }
+
+    // Upper bound from the residual graph: if the sink can't be reached over arcs of at
+    // least threshold, the reached set is a cut and no more than its residual capacity
+    // can be added to the flow; otherwise the source and sink cuts still bound it
+    Flow upper_bound(size_t from, size_t to, Flow flow, Capacity threshold) const {
+        const auto size = _graph.size();
+        std::vector<bool> reached(size, false);
+        std::vector<size_t> stack(1, from);
+        reached[from] = true;
+
+        while(!stack.empty()) {
+            const auto u = stack.back();
+            stack.pop_back();
+            for(size_t v = 0; v < size; ++v) {
+                if(reached[v] || !positive(_graph[u][v]) || _graph[u][v] < threshold) continue;
+                reached[v] = true;
+                stack.push_back(v);
+            }
+        }
+
+        Flow bound = flow;
+        if(!reached[to]) {
+            for(size_t u = 0; u < size; ++u) {
+                if(!reached[u]) continue;
+                for(size_t v = 0; v < size; ++v) {
+                    if(!reached[v]) bound += _graph[u][v];
+                }
             }
+            return bound;
+        }
+
+        Flow source = 0, sink = 0;
+        for(size_t v = 0; v < size; ++v) {
+            source += _graph[from][v];
+            sink += _graph[v][to];
         }
-        return 0;
+        return bound + std::min(source, sink);
+    }
+
+    Flow augment_all(size_t from, size_t to, Capacity threshold) {
+        Flow total_flow = 0;
+        std::vector<bool> visited(_graph.size(), false);
+
+        while(auto flow = dfs(from, to, visited, threshold)) {
+            total_flow += flow;
+            ++_augmentations;
+            visited.assign(visited.size(), false);
+        }
+        return total_flow;
     }
 
 public:
     explicit Graph(size_t size) {
-        _graph.resize(size, std::vector<int>(size));
+        _graph.resize(size, std::vector<Capacity>(size));
     }
 
-    void add_edge(size_t from, size_t to, size_t capacity) {
+    void add_edge(size_t from, size_t to, Capacity capacity) {
         _graph[from][to] += capacity;
     }
 
-    size_t max_flow(size_t from, size_t to) {
+    Flow max_flow(size_t from, size_t to) {
+        return augment_all(from, to, 0);
+    }
+
+    // Capacity scaling: phase delta only augments along residual arcs of at least delta,
+    // O(E log U) augmentations in total
+    Flow max_flow_scaling(size_t from, size_t to) {
+        Flow total_flow = 0;
+        for(const auto threshold : thresholds()) {
+            total_flow += augment_all(from, to, threshold);
+        }
+        return total_flow;
+    }
+
+    // Anytime capacity scaling on a worker thread, in slices of at most `slice`
+    // augmentations. `report` gets the progress after every slice. The solve ends when
+    // the flow is optimal, `cancel` is set or the deadline passes, and the future holds
+    // the last progress. The graph must not be touched until the future is ready.
+    std::future<Progress> max_flow_async(size_t from, size_t to,
+                                         std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                                         const std::atomic<bool>* cancel = nullptr,
+                                         std::function<void(const Progress&)> report = {},
+                                         size_t slice = 64) {
+        return std::async(std::launch::async, [=] {
+            auto stopped = [&] {
+                return (cancel && cancel->load(std::memory_order_relaxed)) || std::chrono::steady_clock::now() >= deadline;
+            };
+
+            std::vector<bool> visited(_graph.size());
+            Progress progress{ 0, upper_bound(from, to, 0, 0), _augmentations, false };
+
+            for(const auto threshold : thresholds()) {
+                for(bool exhausted = false; !exhausted; ) {
+                    for(size_t i = 0; i < slice && !stopped(); ++i) {
+                        visited.assign(visited.size(), false);
+                        const auto flow = dfs(from, to, visited, threshold);
+                        if(!flow) {
+                            exhausted = true;
+                            break;
+                        }
+                        progress.flow += flow;
+                        ++_augmentations;
+                    }
+
+                    progress.upper_bound = std::min(progress.upper_bound, upper_bound(from, to, progress.flow, threshold));
+                    progress.augmentations = _augmentations;
+                    progress.optimal = exhausted && threshold == 0;
+                    if(report) report(progress);
+
+                    if(progress.optimal || stopped()) return progress;
+                }
+            }
+            return progress;
+        });
+    }
+
+    Capacity get_capacity(size_t from, size_t to) {
+        return _graph[from][to];
+    }
+
+    size_t augmentations() const {
+        return _augmentations;
+    }
+};
+
+// Tag for unit capacity networks (edge-disjoint paths): Graph<UnitCapacity> keeps every
+// edge as a unit arc of a CSR residual graph and runs Dinic phases. A phase is O(E), the
+// whole run O(E * min(V^(2/3), sqrt(E))), O(E * sqrt(V)) on unit networks. Memory is O(V + E).
+struct UnitCapacity {};
+
+template <>
+class Graph<UnitCapacity> {
+public:
+    using Flow = size_t;
+
+private:
+    static constexpr size_t unvisited = std::numeric_limits<size_t>::max();
+
+    size_t _size;
+    std::vector<std::pair<size_t, size_t>> _edges;
+    std::vector<size_t> _arc;                   // forward arc of every edge, empty until built
+
+    // CSR of the arcs by tail, every edge has a forward arc and a paired backward arc
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<char> _residual;
+
+    std::vector<size_t> _level;
+    std::vector<size_t> _current;               // current arc of every vertex
+
+private:
+    // Lays the edges out as arcs, keeping the flow of the ones already there
+    void build() {
+        if(!_offsets.empty() && _arc.size() == _edges.size()) return;
+
+        std::vector<char> flow(_edges.size(), 0);
+        for(size_t edge = 0; edge < _arc.size(); ++edge) {
+            flow[edge] = _residual[ _reverse[ _arc[edge] ] ];
+        }
+
+        _offsets.assign(_size + 1, 0);
+        for(const auto& [from, to] : _edges) {
+            ++_offsets[from + 1];
+            ++_offsets[to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) _offsets[v + 1] += _offsets[v];
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+        _arc.resize(_edges.size());
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(size_t edge = 0; edge < _edges.size(); ++edge) {
+            const auto [from, to] = _edges[edge];
+            const auto forward = position[from]++;
+            const auto backward = position[to]++;
+
+            _heads[forward] = to;
+            _heads[backward] = from;
+            _reverse[forward] = backward;
+            _reverse[backward] = forward;
+            _residual[forward] = !flow[edge];
+            _residual[backward] = flow[edge];
+            _arc[edge] = forward;
+        }
+    }
+
+    bool bfs(size_t start, size_t finish) {
+        _level.assign(_size, unvisited);
+        _level[start] = 0;
+
+        std::vector<size_t> queue(1, start);
+        for(size_t i = 0; i < queue.size() && _level[finish] == unvisited; ++i) {
+            const auto from = queue[i];
+            for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+                const auto to = _heads[arc];
+                if(!_residual[arc] || _level[to] != unvisited) continue;
+
+                _level[to] = _level[from] + 1;
+                queue.push_back(to);
+            }
+        }
+        return _level[finish] != unvisited;
+    }
+
+    // Every arc is either saturated or leads to a dead end once, O(E) per phase
+    size_t blocking_flow(size_t start, size_t finish) {
+        _current.assign(_offsets.begin(), _offsets.end() - 1);
+
         size_t total_flow = 0;
-        std::vector<bool> visited(_graph.size(), false);
+        std::vector<size_t> path;
+        for(auto from = start; ; ) {
+            if(from == finish) {
+                for(const auto arc : path) {
+                    _residual[arc] = 0;
+                    _residual[ _reverse[arc] ] = 1;
+                }
+                ++total_flow;
+                path.clear();
+                from = start;
+                continue;
+            }
 
-        while(auto flow = dfs(from, to, visited, std::numeric_limits<int>::max())) {
-            total_flow += flow;
-            visited.assign(visited.size(), false);
+            auto& arc = _current[from];
+            while(arc < _offsets[from + 1] && !(_residual[arc] && _level[ _heads[arc] ] == _level[from] + 1)) ++arc;
+
+            if(arc < _offsets[from + 1]) {
+                path.push_back(arc);
+                from = _heads[arc];
+                continue;
+            }
+
+            if(from == start) break;
+            _level[from] = unvisited;                   // dead end
+            from = _heads[ _reverse[path.back()] ];
+            path.pop_back();
+        }
+        return total_flow;
+    }
+
+public:
+    explicit Graph(size_t size) : _size(size) {}
+
+    // Parallel edges are separate unit edges
+    void add_edge(size_t from, size_t to) {
+        _edges.emplace_back(from, to);
+    }
+
+    Flow max_flow(size_t from, size_t to) {
+        build();
+
+        Flow total_flow = 0;
+        while(bfs(from, to)) {
+            total_flow += blocking_flow(from, to);
         }
         return total_flow;
     }
 
     int get_capacity(size_t from, size_t to) {
-        return _graph[from][to];
+        build();
+
+        int capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
     }
 };
 
+#ifndef MAX_FLOW_BENCHMARK
 int main() {
-    std::vector<std::vector<size_t>> edges = {
+    std::vector<std::vector<long long>> edges = {
         { 0, 1, 6 },
         { 0, 2, 14 },
         { 1, 2, 1 },
@@ -62,7 +379,7 @@ int main() {
         { 4, 5, 12 }
     };
 
-    Graph graph(6);
+    Graph<long long> graph(6);
     for(const auto& edge : edges) {
         graph.add_edge(edge[0], edge[1], edge[2]);
     }
@@ -72,6 +389,33 @@ int main() {
     for(const auto& edge : edges) {
         std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
     }
-    
+
+    Graph<long long> scaling(6);
+    for(const auto& edge : edges) {
+        scaling.add_edge(edge[0], edge[1], edge[2]);
+    }
+    std::cout << std::endl << "Max flow with capacity scaling: " << scaling.max_flow_scaling(0, 5) << std::endl << std::endl;
+
+    Graph<long long> anytime(6);
+    for(const auto& edge : edges) {
+        anytime.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    std::atomic<bool> cancel(false);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    auto solve = anytime.max_flow_async(0, 5, deadline, &cancel, [](const Graph<long long>::Progress& progress) {
+        std::cout << "Flow " << progress.flow << ", at most " << progress.upper_bound << std::endl;
+    }, 1);
+
+    const auto result = solve.get();
+    std::cout << "Anytime max flow: " << result.flow << (result.optimal ? " (optimal)" : "") << std::endl;
+
+    Graph<UnitCapacity> paths(6);
+    for(const auto& edge : edges) {
+        paths.add_edge(edge[0], edge[1]);
+    }
+    std::cout << std::endl << "Edge-disjoint paths: " << paths.max_flow(0, 5) << std::endl;
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,307 @@
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+
+// Global minimum cut of an undirected capacity graph, without fixing a source and a
+// sink. Stoer-Wagner is exact and O(V^3) on an adjacency matrix, for dense graphs;
+// Karger-Stein is randomised and works on edge lists, for sparse graphs. Both return
+// the cut value and side[v], set for the vertices on one side of the cut.
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        long long capacity;
+    };
+
+    using Cut = std::pair<size_t, std::vector<bool>>;
+
+    size_t _size;
+    size_t _threads;
+    std::vector<Edge> _edges;
+
+private:
+    static Cut stoer_wagner(std::vector<std::vector<long long>> matrix) {
+        const auto size = matrix.size();
+
+        std::vector<std::vector<size_t>> members(size);
+        for(size_t v = 0; v < size; ++v) {
+            members[v].push_back(v);
+        }
+
+        auto best = std::numeric_limits<long long>::max();
+        std::vector<size_t> best_side;
+
+        std::vector<bool> merged(size, false);
+        std::vector<bool> added(size);
+        std::vector<long long> weight(size);
+
+        // Every phase orders the vertices by maximum adjacency, the last one is cut from
+        // the rest and then merged into the one before it
+        for(auto phase = size; phase > 1; --phase) {
+            added.assign(size, false);
+            weight.assign(size, 0);
+
+            size_t previous = 0;
+            for(size_t i = 0; i < phase; ++i) {
+                size_t next = size;
+                for(size_t v = 0; v < size; ++v) {
+                    if(merged[v] || added[v]) continue;
+                    if(next == size || weight[v] > weight[next]) next = v;
+                }
+
+                if(i + 1 < phase) {
+                    added[next] = true;
+                    for(size_t v = 0; v < size; ++v) {
+                        weight[v] += matrix[next][v];
+                    }
+                    previous = next;
+                    continue;
+                }
+
+                if(weight[next] < best) {
+                    best = weight[next];
+                    best_side = members[next];
+                }
+
+                for(size_t v = 0; v < size; ++v) {
+                    matrix[previous][v] += matrix[next][v];
+                    matrix[v][previous] = matrix[previous][v];
+                }
+                members[previous].insert(members[previous].end(), members[next].begin(), members[next].end());
+                merged[next] = true;
+            }
+        }
+
+        std::vector<bool> side(size, false);
+        for(const auto v : best_side) {
+            side[v] = true;
+        }
+        return { size > 1 ? static_cast<size_t>(best) : 0, side };
+    }
+
+    static std::vector<std::vector<long long>> adjacency(const std::vector<Edge>& edges, size_t size) {
+        std::vector<std::vector<long long>> matrix(size, std::vector<long long>(size, 0));
+        for(const auto& edge : edges) {
+            if(edge.from == edge.to) continue;
+            matrix[edge.from][edge.to] += edge.capacity;
+            matrix[edge.to][edge.from] += edge.capacity;
+        }
+        return matrix;
+    }
+
+    static size_t find(std::vector<size_t>& parent, size_t v) {
+        while(parent[v] != v) {
+            v = parent[v] = parent[ parent[v] ];
+        }
+        return v;
+    }
+
+    // Contracts random edges, each picked with probability proportional to its capacity,
+    // until `target` vertices are left. Contracting in the order of exponential keys
+    // -ln(U) / capacity is the same random process as picking one edge at a time.
+    // mapping[v] is the contracted vertex of v, parallel edges are merged.
+    static size_t contract(const std::vector<Edge>& edges, size_t size, size_t target, std::mt19937_64& random,
+                           std::vector<size_t>& mapping, std::vector<Edge>& contracted) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        std::vector<std::pair<double, size_t>> keys;
+        keys.reserve(edges.size());
+        for(size_t i = 0; i < edges.size(); ++i) {
+            if(edges[i].capacity > 0) keys.emplace_back(-std::log1p(-uniform(random)) / edges[i].capacity, i);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<size_t> parent(size);
+        std::iota(parent.begin(), parent.end(), 0);
+
+        auto components = size;
+        for(const auto& key : keys) {
+            if(components <= target) break;
+
+            const auto from = find(parent, edges[key.second].from);
+            const auto to = find(parent, edges[key.second].to);
+            if(from == to) continue;
+
+            parent[from] = to;
+            --components;
+        }
+
+        const auto none = std::numeric_limits<size_t>::max();
+        std::vector<size_t> label(size, none);
+        mapping.resize(size);
+
+        size_t count = 0;
+        for(size_t v = 0; v < size; ++v) {
+            auto& root = label[ find(parent, v) ];
+            if(root == none) root = count++;
+            mapping[v] = root;
+        }
+
+        contracted.clear();
+        for(const auto& edge : edges) {
+            auto from = mapping[edge.from];
+            auto to = mapping[edge.to];
+            if(from == to) continue;
+            if(from > to) std::swap(from, to);
+            contracted.push_back({ from, to, edge.capacity });
+        }
+
+        std::sort(contracted.begin(), contracted.end(), [](const Edge& a, const Edge& b) {
+            return a.from != b.from ? a.from < b.from : a.to < b.to;
+        });
+
+        size_t last = 0;
+        for(size_t i = 0; i < contracted.size(); ++i) {
+            if(last > 0 && contracted[last - 1].from == contracted[i].from && contracted[last - 1].to == contracted[i].to) {
+                contracted[last - 1].capacity += contracted[i].capacity;
+            } else {
+                contracted[last++] = contracted[i];
+            }
+        }
+        contracted.resize(last);
+        return count;
+    }
+
+    // One Karger-Stein run on a connected graph: contract to size / sqrt(2) + 1 twice
+    // independently and keep the better of the two recursive cuts
+    static Cut karger_stein(const std::vector<Edge>& edges, size_t size, std::mt19937_64& random) {
+        if(size <= 6) return stoer_wagner(adjacency(edges, size));
+
+        const auto target = static_cast<size_t>(std::ceil(1.0 + size / std::sqrt(2.0)));
+
+        Cut best(std::numeric_limits<size_t>::max(), {});
+        std::vector<size_t> mapping;
+        std::vector<Edge> contracted;
+
+        for(size_t run = 0; run < 2; ++run) {
+            const auto count = contract(edges, size, target, random, mapping, contracted);
+            if(count >= size) return stoer_wagner(adjacency(edges, size));     // nothing left to contract
+            const auto [value, side] = karger_stein(contracted, count, random);
+            if(value >= best.first) continue;
+
+            best.first = value;
+            best.second.resize(size);
+            for(size_t v = 0; v < size; ++v) {
+                best.second[v] = side[ mapping[v] ];
+            }
+        }
+        return best;
+    }
+
+public:
+    // threads == 0 picks std::thread::hardware_concurrency()
+    explicit Graph(size_t size, size_t threads = 0) : _size(size), _threads(threads) {
+        if(_threads == 0) _threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Undirected edge
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+    }
+
+    // Exact minimum cut, O(V^3)
+    Cut stoer_wagner() const {
+        return stoer_wagner(adjacency(_edges, _size));
+    }
+
+    // Best cut of `trials` independent Karger-Stein runs, spread over the threads. A run
+    // finds a minimum cut with probability Omega(1 / log V), the default of log^2 V runs
+    // fails with probability O(1 / V). Runs are seeded by seed and their index, so the
+    // result doesn't depend on the number of threads.
+    Cut karger_stein(size_t trials = 0, std::uint64_t seed = 1) const {
+        if(_size < 2) return { 0, std::vector<bool>(_size, false) };
+
+        // A graph disconnected by its positive edges has a cut of zero, which contraction
+        // never has to look for: it only contracts positive edges
+        std::vector<size_t> parent(_size);
+        std::iota(parent.begin(), parent.end(), 0);
+        for(const auto& edge : _edges) {
+            if(edge.capacity <= 0) continue;
+            parent[ find(parent, edge.from) ] = find(parent, edge.to);
+        }
+
+        const auto root = find(parent, 0);
+        if(std::any_of(parent.begin(), parent.end(), [&](size_t v) { return find(parent, v) != root; })) {
+            std::vector<bool> side(_size);
+            for(size_t v = 0; v < _size; ++v) {
+                side[v] = find(parent, v) == root;
+            }
+            return { 0, side };
+        }
+
+        if(trials == 0) {
+            const auto log = static_cast<size_t>(std::ceil(std::log2(_size)));
+            trials = std::max<size_t>(1, log * log);
+        }
+
+        std::vector<std::pair<Cut, size_t>> best(_threads, { Cut(std::numeric_limits<size_t>::max(), {}), 0 });
+        std::atomic<size_t> next(0);
+
+        auto work = [&](size_t thread) {
+            for(auto trial = next.fetch_add(1); trial < trials; trial = next.fetch_add(1)) {
+                std::seed_seq sequence{ seed, static_cast<std::uint64_t>(trial) };
+                std::mt19937_64 random(sequence);
+
+                auto cut = karger_stein(_edges, _size, random);
+                if(cut.first < best[thread].first.first || (cut.first == best[thread].first.first && trial < best[thread].second)) {
+                    best[thread] = { std::move(cut), trial };
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for(size_t thread = 1; thread < std::min(_threads, trials); ++thread) {
+            workers.emplace_back(work, thread);
+        }
+        work(0);
+        for(auto& worker : workers) worker.join();
+
+        return std::min_element(best.begin(), best.end(), [](const auto& a, const auto& b) {
+            return a.first.first != b.first.first ? a.first.first < b.first.first : a.second < b.second;
+        })->first;
+    }
+};
+
+
+int main() {
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 2 },
+        { 0, 4, 3 },
+        { 1, 2, 3 },
+        { 1, 4, 2 },
+        { 1, 5, 2 },
+        { 2, 3, 4 },
+        { 2, 6, 2 },
+        { 3, 6, 2 },
+        { 3, 7, 2 },
+        { 4, 5, 3 },
+        { 5, 6, 1 },
+        { 6, 7, 3 }
+    };
+
+    Graph graph(8, 4);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    auto print = [](const char* name, const std::pair<size_t, std::vector<bool>>& cut) {
+        std::cout << name << ": " << cut.first << ", side:";
+        for(size_t v = 0; v < cut.second.size(); ++v) {
+            if(cut.second[v]) std::cout << " " << v;
+        }
+        std::cout << std::endl;
+    };
+
+    print("Stoer-Wagner min cut", graph.stoer_wagner());
+    print("Karger-Stein min cut", graph.karger_stein());
+
+    return 0;
+}
@@ -0,0 +1,329 @@
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Gusfield's cut tree over an undirected capacity graph. The n - 1 max-flow runs are
+// speculated in windows: every run in a window works on its own residual copy of the
+// shared CSR graph and is committed in order as long as the tree parent it was
+// computed against hasn't changed, so the tree is exactly the one of the serial method.
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+    };
+
+    size_t _size;
+    size_t _threads;
+    std::vector<Edge> _edges;
+
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<int> _capacity;
+
+    // Cut tree rooted at 0 with binary lifting for path minimum queries
+    std::vector<size_t> _parent;
+    std::vector<size_t> _weight;
+    std::vector<size_t> _depth;
+    std::vector<std::vector<size_t>> _up;
+    std::vector<std::vector<size_t>> _min;
+    bool _built = false;
+
+    // Dinic on a private copy of the residual capacities
+    struct Solver {
+        const Graph& graph;
+        std::vector<int> residual;
+        std::vector<int> levels;
+        std::vector<size_t> current;
+
+        explicit Solver(const Graph& graph) : graph(graph) {}
+
+        bool bfs(size_t start, size_t finish) {
+            levels.assign(graph._size, -1);
+            levels[start] = 0;
+
+            std::queue<size_t> queue;
+            queue.push(start);
+
+            while(!queue.empty()) {
+                const auto from = queue.front();
+                queue.pop();
+
+                for(auto arc = graph._offsets[from]; arc < graph._offsets[from + 1]; ++arc) {
+                    const auto to = graph._heads[arc];
+                    if(residual[arc] == 0 || levels[to] != -1) continue;
+
+                    levels[to] = levels[from] + 1;
+                    queue.push(to);
+                }
+            }
+            return levels[finish] != -1;
+        }
+
+        size_t blocking_flow(size_t start, size_t finish) {
+            for(size_t v = 0; v < graph._size; ++v) {
+                current[v] = graph._offsets[v];
+            }
+
+            size_t total_flow = 0;
+            std::vector<size_t> path;
+            auto from = start;
+
+            while(true) {
+                if(from == finish) {
+                    int flow = std::numeric_limits<int>::max();
+                    for(const auto arc : path) {
+                        flow = std::min(flow, residual[arc]);
+                    }
+
+                    size_t saturated = path.size();
+                    for(size_t i = 0; i < path.size(); ++i) {
+                        residual[ path[i] ] -= flow;
+                        residual[ graph._reverse[path[i]] ] += flow;
+                        if(residual[ path[i] ] == 0 && saturated == path.size()) {
+                            saturated = i;
+                        }
+                    }
+                    total_flow += flow;
+
+                    path.resize(saturated);
+                    from = path.empty() ? start : graph._heads[path.back()];
+                    continue;
+                }
+
+                auto& arc = current[from];
+                while(arc < graph._offsets[from + 1] && (residual[arc] == 0 || levels[ graph._heads[arc] ] != levels[from] + 1)) {
+                    ++arc;
+                }
+
+                if(arc < graph._offsets[from + 1]) {
+                    path.push_back(arc);
+                    from = graph._heads[arc];
+                    continue;
+                }
+
+                levels[from] = -1;
+                if(path.empty()) break;
+
+                path.pop_back();
+                from = path.empty() ? start : graph._heads[path.back()];
+                ++current[from];
+            }
+            return total_flow;
+        }
+
+        // Min cut between start and finish, side[v] is set for the vertices on start's side
+        size_t min_cut(size_t start, size_t finish, std::vector<bool>& side) {
+            residual = graph._capacity;
+            current.resize(graph._size);
+
+            size_t total_flow = 0;
+            while(bfs(start, finish)) {
+                total_flow += blocking_flow(start, finish);
+            }
+
+            bfs(start, finish);
+            side.assign(graph._size, false);
+            for(size_t v = 0; v < graph._size; ++v) {
+                side[v] = levels[v] != -1;
+            }
+            return total_flow;
+        }
+    };
+
+private:
+    void build_graph() {
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _capacity.resize(arcs);
+
+        // Undirected edge: both arcs of the pair start with the full capacity
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(const auto& edge : _edges) {
+            const auto forward = position[edge.from]++;
+            const auto backward = position[edge.to]++;
+
+            _heads[forward] = edge.to;
+            _reverse[forward] = backward;
+            _capacity[forward] = edge.capacity;
+
+            _heads[backward] = edge.from;
+            _reverse[backward] = forward;
+            _capacity[backward] = edge.capacity;
+        }
+    }
+
+    void build_tree() {
+        _parent.assign(_size, 0);
+        _weight.assign(_size, 0);
+
+        const auto window_size = 2 * _threads;
+        std::vector<std::vector<bool>> sides(window_size);
+        std::vector<size_t> flows(window_size);
+        std::vector<size_t> parents(window_size);
+
+        for(size_t first = 1; first < _size; ) {
+            const auto last = std::min(_size, first + window_size);
+
+            std::atomic<size_t> next(first);
+            auto work = [&] {
+                Solver solver(*this);
+                for(auto i = next.fetch_add(1); i < last; i = next.fetch_add(1)) {
+                    parents[i - first] = _parent[i];
+                    flows[i - first] = solver.min_cut(i, _parent[i], sides[i - first]);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for(size_t thread = 1; thread < std::min(_threads, last - first); ++thread) {
+                workers.emplace_back(work);
+            }
+            work();
+            for(auto& worker : workers) worker.join();
+
+            // Commit in order until a run turns out to be computed against a stale parent
+            auto i = first;
+            for(; i < last && _parent[i] == parents[i - first]; ++i) {
+                const auto& side = sides[i - first];
+                _weight[i] = flows[i - first];
+
+                for(auto j = i + 1; j < _size; ++j) {
+                    if(side[j] && _parent[j] == _parent[i]) _parent[j] = i;
+                }
+            }
+            first = i;
+        }
+    }
+
+    void build_lifting() {
+        std::vector<std::vector<size_t>> children(_size);
+        for(size_t v = 1; v < _size; ++v) {
+            children[ _parent[v] ].push_back(v);
+        }
+
+        size_t levels = 1;
+        while((size_t(1) << levels) < _size) ++levels;
+
+        _depth.assign(_size, 0);
+        _up.assign(levels, std::vector<size_t>(_size, 0));
+        _min.assign(levels, std::vector<size_t>(_size, std::numeric_limits<size_t>::max()));
+
+        std::vector<size_t> order(1, 0);
+        for(size_t i = 0; i < order.size(); ++i) {
+            const auto v = order[i];
+            for(const auto child : children[v]) {
+                _depth[child] = _depth[v] + 1;
+                _up[0][child] = v;
+                _min[0][child] = _weight[child];
+                order.push_back(child);
+            }
+        }
+
+        for(size_t level = 1; level < levels; ++level) {
+            for(const auto v : order) {
+                const auto middle = _up[level - 1][v];
+                _up[level][v] = _up[level - 1][middle];
+                _min[level][v] = std::min(_min[level - 1][v], _min[level - 1][middle]);
+            }
+        }
+    }
+
+    void build() {
+        build_graph();
+        build_tree();
+        build_lifting();
+        _built = true;
+    }
+
+public:
+    // threads == 0 picks std::thread::hardware_concurrency()
+    explicit Graph(size_t size, size_t threads = 0) : _size(size), _threads(threads) {
+        if(_threads == 0) _threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Undirected edge, adding edges after a query rebuilds the cut tree
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+        _built = false;
+    }
+
+    // Min cut value between two vertices, the minimum edge on their cut tree path
+    size_t min_cut(size_t from, size_t to) {
+        if(!_built) build();
+
+        auto result = std::numeric_limits<size_t>::max();
+        if(_depth[from] < _depth[to]) std::swap(from, to);
+
+        for(size_t level = _up.size(); level-- > 0; ) {
+            if(_depth[from] - _depth[to] >= (size_t(1) << level)) {
+                result = std::min(result, _min[level][from]);
+                from = _up[level][from];
+            }
+        }
+        if(from == to) return result;
+
+        for(size_t level = _up.size(); level-- > 0; ) {
+            if(_up[level][from] != _up[level][to]) {
+                result = std::min({ result, _min[level][from], _min[level][to] });
+                from = _up[level][from];
+                to = _up[level][to];
+            }
+        }
+        return std::min({ result, _min[0][from], _min[0][to] });
+    }
+
+    void print() {
+        if(!_built) build();
+
+        for(size_t v = 1; v < _size; ++v) {
+            std::cout << "Tree edge " << v << " - " << _parent[v] << ": " << _weight[v] << std::endl;
+        }
+    }
+};
+
+
+int main() {
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 1 },
+        { 0, 2, 7 },
+        { 1, 2, 1 },
+        { 1, 3, 3 },
+        { 1, 4, 2 },
+        { 2, 4, 4 },
+        { 3, 4, 1 },
+        { 3, 5, 6 },
+        { 4, 5, 2 }
+    };
+
+    Graph graph(6, 4);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    graph.print();
+    std::cout << std::endl;
+
+    for(size_t from = 0; from < 6; ++from) {
+        for(size_t to = from + 1; to < 6; ++to) {
+            std::cout << "Min cut " << from << " - " << to << ": " << graph.min_cut(from, to) << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+// Min-cost max-flow on a CSR residual graph with a cost per arc. Two solvers share
+// the layout: successive shortest paths with Johnson potentials and a binary heap,
+// and Goldberg-Tarjan cost scaling for large integer costs. The graph must not have
+// negative cost cycles.
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+        int cost;
+    };
+
+    static constexpr long long INF = std::numeric_limits<long long>::max() / 4;
+
+    size_t _size;
+    std::vector<Edge> _edges;
+
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<long long> _residual;
+    std::vector<long long> _cost;
+    std::vector<size_t> _forward;     // forward arc of every edge
+
+    // Arc pair of the sink -> source edge used by cost scaling, skipped by get_capacity
+    size_t _bypass = std::numeric_limits<size_t>::max();
+
+private:
+    void build(size_t from, size_t to, long long bypass_capacity, long long bypass_cost) {
+        const auto edges = _edges.size() + 1;
+
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        ++_offsets[to + 1];
+        ++_offsets[from + 1];
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+        _cost.resize(arcs);
+        _forward.resize(_edges.size());
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(size_t i = 0; i < edges; ++i) {
+            const auto last = (i == _edges.size());
+            const auto tail = last ? to : _edges[i].from;
+            const auto head = last ? from : _edges[i].to;
+
+            const auto forward = position[tail]++;
+            const auto backward = position[head]++;
+
+            _heads[forward] = head;
+            _reverse[forward] = backward;
+            _residual[forward] = last ? bypass_capacity : _edges[i].capacity;
+            _cost[forward] = last ? bypass_cost : _edges[i].cost;
+
+            _heads[backward] = tail;
+            _reverse[backward] = forward;
+            _residual[backward] = 0;
+            _cost[backward] = -_cost[forward];
+
+            if(last) _bypass = forward;
+            else _forward[i] = forward;
+        }
+    }
+
+    long long total_cost() const {
+        long long cost = 0;
+        for(size_t i = 0; i < _edges.size(); ++i) {
+            cost += _residual[ _reverse[_forward[i]] ] * _edges[i].cost;
+        }
+        return cost;
+    }
+
+    // Bellman-Ford (queue based) potentials, only needed when some costs are negative
+    std::vector<long long> initial_potentials(size_t start) const {
+        std::vector<long long> distance(_size, INF);
+        std::vector<bool> queued(_size, false);
+
+        std::queue<size_t> queue;
+        distance[start] = 0;
+        queue.push(start);
+
+        while(!queue.empty()) {
+            const auto from = queue.front();
+            queue.pop();
+            queued[from] = false;
+
+            for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+                const auto to = _heads[arc];
+                if(_residual[arc] == 0 || distance[from] + _cost[arc] >= distance[to]) continue;
+
+                distance[to] = distance[from] + _cost[arc];
+                if(!queued[to]) {
+                    queued[to] = true;
+                    queue.push(to);
+                }
+            }
+        }
+
+        for(auto& d : distance) {
+            if(d == INF) d = 0;
+        }
+        return distance;
+    }
+
+    void refine(std::vector<long long>& prices, long long epsilon) {
+        std::vector<long long> excess(_size, 0);
+        std::vector<size_t> current(_offsets.begin(), _offsets.end() - 1);
+        std::queue<size_t> active;
+
+        auto reduced_cost = [&](size_t from, size_t arc) {
+            return _cost[arc] + prices[from] - prices[ _heads[arc] ];
+        };
+
+        auto push = [&](size_t from, size_t arc, long long flow) {
+            const auto to = _heads[arc];
+            _residual[arc] -= flow;
+            _residual[ _reverse[arc] ] += flow;
+            excess[from] -= flow;
+            if(excess[to] <= 0 && excess[to] + flow > 0) active.push(to);
+            excess[to] += flow;
+        };
+
+        // Saturating every negative arc makes the pseudoflow 0-optimal
+        for(size_t from = 0; from < _size; ++from) {
+            for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+                if(_residual[arc] > 0 && reduced_cost(from, arc) < 0) push(from, arc, _residual[arc]);
+            }
+        }
+
+        while(!active.empty()) {
+            const auto from = active.front();
+            active.pop();
+
+            while(excess[from] > 0) {
+                auto& arc = current[from];
+                if(arc == _offsets[from + 1]) {
+                    auto price = -INF;
+                    for(auto it = _offsets[from]; it < _offsets[from + 1]; ++it) {
+                        if(_residual[it] > 0) price = std::max(price, prices[ _heads[it] ] - _cost[it] - epsilon);
+                    }
+                    prices[from] = price;
+                    arc = _offsets[from];
+                    continue;
+                }
+
+                if(_residual[arc] > 0 && reduced_cost(from, arc) < 0) {
+                    push(from, arc, std::min(excess[from], _residual[arc]));
+                } else {
+                    ++arc;
+                }
+            }
+        }
+    }
+
+public:
+    explicit Graph(size_t size) : _size(size) {}
+
+    void add_edge(size_t from, size_t to, int capacity, int cost) {
+        _edges.push_back({ from, to, capacity, cost });
+    }
+
+    // Successive shortest paths, returns <flow, cost>
+    std::pair<size_t, long long> min_cost_flow(size_t from, size_t to) {
+        build(from, to, 0, 0);
+
+        const auto negative = std::any_of(_edges.begin(), _edges.end(), [](const Edge& edge) { return edge.cost < 0; });
+        auto potentials = negative ? initial_potentials(from) : std::vector<long long>(_size, 0);
+
+        using Item = std::pair<long long, size_t>;    // <distance, vertex>
+        std::vector<long long> distance(_size);
+        std::vector<size_t> parent_arc(_size);
+
+        size_t total_flow = 0;
+        while(true) {
+            distance.assign(_size, INF);
+            distance[from] = 0;
+
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+            heap.emplace(0, from);
+
+            while(!heap.empty()) {
+                const auto [dist, v] = heap.top();
+                heap.pop();
+                if(dist != distance[v]) continue;
+
+                for(auto arc = _offsets[v]; arc < _offsets[v + 1]; ++arc) {
+                    const auto w = _heads[arc];
+                    if(_residual[arc] == 0) continue;
+
+                    const auto candidate = dist + _cost[arc] + potentials[v] - potentials[w];
+                    if(candidate < distance[w]) {
+                        distance[w] = candidate;
+                        parent_arc[w] = arc;
+                        heap.emplace(candidate, w);
+                    }
+                }
+            }
+
+            if(distance[to] == INF) break;
+
+            for(size_t v = 0; v < _size; ++v) {
+                if(distance[v] != INF) potentials[v] += distance[v];
+            }
+
+            auto flow = INF;
+            for(auto v = to; v != from; v = _heads[ _reverse[parent_arc[v]] ]) {
+                flow = std::min(flow, _residual[ parent_arc[v] ]);
+            }
+            for(auto v = to; v != from; v = _heads[ _reverse[parent_arc[v]] ]) {
+                _residual[ parent_arc[v] ] -= flow;
+                _residual[ _reverse[parent_arc[v]] ] += flow;
+            }
+            total_flow += flow;
+        }
+
+        return { total_flow, total_cost() };
+    }
+
+    // Cost scaling on the circulation closed by a sink -> source arc whose cost is
+    // low enough that every unit of s-t flow pays off, returns <flow, cost>.
+    // The bypass costs about n^2 * max|cost| once scaled, and prices grow to a few n times
+    // that; when it doesn't fit in a long long this falls back to min_cost_flow().
+    std::pair<size_t, long long> min_cost_flow_scaling(size_t from, size_t to) {
+        long long max_cost = 0;
+        long long capacity = 0;
+        for(const auto& edge : _edges) {
+            max_cost = std::max<long long>(max_cost, std::abs(edge.cost));
+            if(edge.from == from) capacity += edge.capacity;
+        }
+
+        const auto n = std::max<long long>(1, _size);
+        const auto limit = std::numeric_limits<long long>::max() / (4 * (n + 1)) / (n + 1);
+        if(max_cost > (limit - 1) / n) return min_cost_flow(from, to);
+
+        // Scaling costs by n makes an 1-optimal flow optimal for the original costs
+        const auto scale = static_cast<long long>(_size) + 1;
+        build(from, to, capacity, -(static_cast<long long>(_size) * max_cost + 1));
+        for(auto& cost : _cost) {
+            cost *= scale;
+        }
+
+        long long epsilon = 1;
+        for(const auto cost : _cost) {
+            epsilon = std::max(epsilon, std::abs(cost));
+        }
+
+        std::vector<long long> prices(_size, 0);
+        do {
+            epsilon = std::max<long long>(1, epsilon / 8);
+            refine(prices, epsilon);
+        } while(epsilon > 1);
+
+        for(auto& cost : _cost) {
+            cost /= scale;
+        }
+
+        return { static_cast<size_t>(_residual[ _reverse[_bypass] ]), total_cost() };
+    }
+
+    // Residual capacity from -> to, summed over parallel and reverse arcs
+    long long get_capacity(size_t from, size_t to) const {
+        long long capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(arc == _bypass || arc == _reverse[_bypass]) continue;
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
+    }
+};
+
+
+int main() {
+    std::vector<std::vector<int>> edges = {    // <from, to, capacity, cost>
+        { 0, 1, 6, 2 },
+        { 0, 2, 14, 4 },
+        { 1, 2, 1, 1 },
+        { 1, 3, 5, 6 },
+        { 2, 3, 7, 2 },
+        { 2, 4, 10, 3 },
+        { 3, 4, 1, 1 },
+        { 3, 5, 11, 3 },
+        { 4, 5, 12, 5 }
+    };
+
+    Graph graph(6);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2], edge[3]);
+    }
+
+    const auto [flow, cost] = graph.min_cost_flow(0, 5);
+    std::cout << "Max flow: " << flow << ", min cost: " << cost << std::endl << std::endl;
+
+    for(const auto& edge : edges) {
+        std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
+    }
+
+    const auto [scaling_flow, scaling_cost] = graph.min_cost_flow_scaling(0, 5);
+    std::cout << std::endl << "Cost scaling: max flow: " << scaling_flow << ", min cost: " << scaling_cost << std::endl;
+
+    return 0;
+}
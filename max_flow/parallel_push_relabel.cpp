@@ -0,0 +1,399 @@
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    std::function<void(size_t)> _task;
+    size_t _generation = 0;
+    size_t _pending = 0;
+    bool _stop = false;
+
+private:
+    void work(size_t thread) {
+        size_t generation = 0;
+        while(true) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stop || _generation != generation; });
+            if(_stop) return;
+
+            generation = _generation;
+            lock.unlock();
+
+            _task(thread);
+
+            lock.lock();
+            if(--_pending == 0) _done.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads) {
+        for(size_t thread = 1; thread < threads; ++thread) {
+            _workers.emplace_back(&ThreadPool::work, this, thread);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for(auto& worker : _workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {
+        return _workers.size() + 1;
+    }
+
+    // Calls body(begin, end, thread) over chunks of [0, count), the caller works as thread 0
+    template<typename Body>
+    void parallel_for(size_t count, Body&& body) {
+        if(_workers.empty() || count < 2) {
+            if(count > 0) body(0, count, 0);
+            return;
+        }
+
+        const size_t chunk = std::max<size_t>(1, std::min<size_t>(256, count / (4 * size())));
+        std::atomic<size_t> next(0);
+        auto run = [&](size_t thread) {
+            for(auto begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+                body(begin, std::min(begin + chunk, count), thread);
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = run;
+            _pending = _workers.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [&] { return _pending == 0; });
+    }
+};
+
+// Synchronous-phase parallel push-relabel. Each round discharges every active
+// vertex against the labels frozen at the start of the round, then relabels the
+// vertices left with excess. Two endpoints of a residual arc can never both see it
+// admissible, so each arc pair has a single writer per round and only the excess
+// arriving at a vertex needs an atomic. With one thread the rounds run in order
+// and the result is deterministic.
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+    };
+
+    size_t _size;
+    size_t _threads;
+    std::vector<Edge> _edges;
+    bool _built = false;
+
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<int> _residual;
+
+    std::vector<size_t> _labels;
+    std::vector<size_t> _new_labels;
+    std::vector<long long> _excess;
+    std::vector<size_t> _current;
+    std::unique_ptr<std::atomic<long long>[]> _incoming;
+    std::unique_ptr<std::atomic<bool>[]> _queued;
+
+    std::vector<size_t> _active;
+    std::vector<std::vector<size_t>> _local;     // per-thread lists of vertices for the next round
+    std::atomic<size_t> _pushes{0};
+
+private:
+    void build() {
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(const auto& edge : _edges) {
+            const auto forward = position[edge.from]++;
+            const auto backward = position[edge.to]++;
+
+            _heads[forward] = edge.to;
+            _reverse[forward] = backward;
+            _residual[forward] = edge.capacity;
+
+            _heads[backward] = edge.from;
+            _reverse[backward] = forward;
+            _residual[backward] = 0;
+        }
+        _built = true;
+    }
+
+    void gather(std::vector<size_t>& list) {
+        list.clear();
+        for(auto& local : _local) {
+            list.insert(list.end(), local.begin(), local.end());
+            local.clear();
+        }
+    }
+
+    // Level-synchronous reverse BFS from the sink, then from the source for the
+    // vertices that can't reach the sink any more
+    void global_relabel(ThreadPool& pool, size_t start, size_t finish) {
+        const auto unreached = 2 * _size;
+        pool.parallel_for(_size, [&](size_t begin, size_t end, size_t) {
+            for(auto v = begin; v < end; ++v) {
+                _labels[v] = unreached;
+                _queued[v].store(false, std::memory_order_relaxed);
+                _current[v] = _offsets[v];
+            }
+        });
+
+        std::vector<size_t> frontier;
+        auto bfs = [&](size_t root, size_t label) {
+            _labels[root] = label;
+            _queued[root].store(true, std::memory_order_relaxed);
+            frontier.assign(1, root);
+
+            while(!frontier.empty()) {
+                pool.parallel_for(frontier.size(), [&](size_t begin, size_t end, size_t thread) {
+                    for(auto i = begin; i < end; ++i) {
+                        const auto to = frontier[i];
+                        for(auto arc = _offsets[to]; arc < _offsets[to + 1]; ++arc) {
+                            const auto from = _heads[arc];
+                            if(_residual[ _reverse[arc] ] == 0 || _queued[from].load(std::memory_order_relaxed)) continue;
+                            if(_queued[from].exchange(true)) continue;
+
+                            _labels[from] = _labels[to] + 1;
+                            _local[thread].push_back(from);
+                        }
+                    }
+                });
+                gather(frontier);
+            }
+        };
+        _queued[start].store(true, std::memory_order_relaxed);
+        bfs(finish, 0);
+        bfs(start, _size);
+
+        pool.parallel_for(_size, [&](size_t begin, size_t end, size_t thread) {
+            for(auto v = begin; v < end; ++v) {
+                _queued[v].store(false, std::memory_order_relaxed);
+                if(_excess[v] > 0 && v != start && v != finish) _local[thread].push_back(v);
+            }
+        });
+        gather(_active);
+    }
+
+    // Returns the number of pushes
+    size_t push(size_t v, size_t thread, size_t start, size_t finish) {
+        size_t pushes = 0;
+        const auto label = _labels[v];
+        for(auto& arc = _current[v]; arc < _offsets[v + 1] && _excess[v] > 0; ++arc) {
+            const auto to = _heads[arc];
+            if(label != _labels[to] + 1 || _residual[arc] == 0) continue;
+
+            const auto flow = static_cast<int>(std::min<long long>(_excess[v], _residual[arc]));
+            _residual[arc] -= flow;
+            _residual[ _reverse[arc] ] += flow;
+            _excess[v] -= flow;
+            ++pushes;
+
+            _incoming[to].fetch_add(flow, std::memory_order_relaxed);
+            if(to != start && to != finish && !_queued[to].exchange(true)) {
+                _local[thread].push_back(to);
+            }
+
+            if(_residual[arc] > 0) break;   // excess is exhausted, keep the arc current
+        }
+        return pushes;
+    }
+
+    size_t relabel(size_t v) {
+        auto label = 2 * _size;
+        for(auto arc = _offsets[v]; arc < _offsets[v + 1]; ++arc) {
+            if(_residual[arc] > 0) label = std::min(label, _labels[ _heads[arc] ] + 1);
+        }
+        return label;
+    }
+
+public:
+    // threads == 0 picks std::thread::hardware_concurrency()
+    explicit Graph(size_t size, size_t threads = 0) : _size(size), _threads(threads) {
+        if(_threads == 0) _threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void set_threads(size_t threads) {
+        _threads = std::max<size_t>(1, threads);
+    }
+
+    // Adding edges after a solve rebuilds the residual graph from scratch.
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+        _built = false;
+    }
+
+    size_t max_flow(size_t from, size_t to) {
+        if(!_built) build();
+
+        ThreadPool pool(_threads);
+        _local.assign(pool.size(), {});
+
+        _labels.assign(_size, 0);
+        _new_labels.assign(_size, 0);
+        _excess.assign(_size, 0);
+        _current.assign(_size, 0);
+        _incoming.reset(new std::atomic<long long>[_size]);
+        _queued.reset(new std::atomic<bool>[_size]);
+        for(size_t v = 0; v < _size; ++v) {
+            _incoming[v].store(0, std::memory_order_relaxed);
+            _queued[v].store(false, std::memory_order_relaxed);
+        }
+
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            const auto flow = _residual[arc];
+            _residual[arc] = 0;
+            _residual[ _reverse[arc] ] += flow;
+            _excess[ _heads[arc] ] += flow;
+            _excess[from] -= flow;
+        }
+
+        global_relabel(pool, from, to);
+
+        const auto global_relabel_threshold = 6 * _size + _offsets[_size] / 2;
+        std::atomic<size_t> work(0);
+        std::vector<size_t> next;
+
+        while(!_active.empty()) {
+            pool.parallel_for(_active.size(), [&](size_t begin, size_t end, size_t thread) {
+                size_t pushes = 0;
+                for(auto i = begin; i < end; ++i) {
+                    pushes += push(_active[i], thread, from, to);
+                }
+                _pushes.fetch_add(pushes, std::memory_order_relaxed);
+            });
+
+            pool.parallel_for(_active.size(), [&](size_t begin, size_t end, size_t thread) {
+                size_t local_work = 0;
+                for(auto i = begin; i < end; ++i) {
+                    const auto v = _active[i];
+                    _new_labels[v] = _labels[v];
+                    if(_excess[v] == 0) continue;
+
+                    _new_labels[v] = relabel(v);
+                    local_work += 12 + _offsets[v + 1] - _offsets[v];
+                    if(!_queued[v].exchange(true)) _local[thread].push_back(v);
+                }
+                work.fetch_add(local_work, std::memory_order_relaxed);
+            });
+
+            pool.parallel_for(_active.size(), [&](size_t begin, size_t end, size_t) {
+                for(auto i = begin; i < end; ++i) {
+                    const auto v = _active[i];
+                    if(_new_labels[v] != _labels[v]) {
+                        _labels[v] = _new_labels[v];
+                        _current[v] = _offsets[v];
+                    }
+                }
+            });
+
+            gather(next);
+            pool.parallel_for(next.size(), [&](size_t begin, size_t end, size_t thread) {
+                for(auto i = begin; i < end; ++i) {
+                    const auto v = next[i];
+                    _excess[v] += _incoming[v].exchange(0, std::memory_order_relaxed);
+                    _queued[v].store(false, std::memory_order_relaxed);
+                    if(_excess[v] > 0 && _labels[v] < 2 * _size) _local[thread].push_back(v);
+                }
+            });
+            gather(_active);
+
+            if(work.load(std::memory_order_relaxed) > global_relabel_threshold) {
+                _excess[from] += _incoming[from].exchange(0);
+                _excess[to] += _incoming[to].exchange(0);
+                global_relabel(pool, from, to);
+                work.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        _excess[from] += _incoming[from].exchange(0);
+        _excess[to] += _incoming[to].exchange(0);
+        return _excess[to];
+    }
+
+    // Residual capacity from -> to, summed over parallel and reverse arcs as in the matrix graphs
+    int get_capacity(size_t from, size_t to) {
+        if(!_built) build();
+
+        int capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
+    }
+
+    size_t pushes() const {
+        return _pushes.load(std::memory_order_relaxed);
+    }
+};
+
+
+#ifndef MAX_FLOW_BENCHMARK
+int main() {
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 6 },
+        { 0, 2, 14 },
+        { 1, 2, 1 },
+        { 1, 3, 5 },
+        { 2, 3, 7 },
+        { 2, 4, 10 },
+        { 3, 4, 1 },
+        { 3, 5, 11 },
+        { 4, 5, 12 }
+    };
+
+    Graph graph(6, 4);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    std::cout << "Max flow: " << graph.max_flow(0, 5) << std::endl << std::endl;
+
+    for(const auto& edge : edges) {
+        std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,255 @@
+#include <vector>
+#include <queue>
+#include <iostream>
+#include <algorithm>
+
+// Highest-label push-relabel with the gap heuristic and periodic global relabeling.
+// Labels run up to 2n, so leftover excess drains back to the source and the
+// residual graph ends up holding a valid flow, not only a preflow.
+class Graph {
+private:
+    struct Edge {
+        size_t from;
+        size_t to;
+        int capacity;
+    };
+
+    size_t _size;
+    std::vector<Edge> _edges;
+    bool _built = false;
+
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _heads;
+    std::vector<size_t> _reverse;
+    std::vector<int> _residual;
+
+    std::vector<size_t> _labels;
+    std::vector<long long> _excess;
+    std::vector<size_t> _current;
+    std::vector<size_t> _count;                  // vertices per label below n, for the gap heuristic
+    std::vector<std::vector<size_t>> _active;    // active vertices bucketed by label
+    size_t _highest = 0;
+    size_t _work = 0;
+    size_t _pushes = 0;
+
+private:
+    void build() {
+        _offsets.assign(_size + 1, 0);
+        for(const auto& edge : _edges) {
+            ++_offsets[edge.from + 1];
+            ++_offsets[edge.to + 1];
+        }
+        for(size_t v = 0; v < _size; ++v) {
+            _offsets[v + 1] += _offsets[v];
+        }
+
+        const auto arcs = _offsets[_size];
+        _heads.resize(arcs);
+        _reverse.resize(arcs);
+        _residual.resize(arcs);
+
+        std::vector<size_t> position(_offsets.begin(), _offsets.end() - 1);
+        for(const auto& edge : _edges) {
+            const auto forward = position[edge.from]++;
+            const auto backward = position[edge.to]++;
+
+            _heads[forward] = edge.to;
+            _reverse[forward] = backward;
+            _residual[forward] = edge.capacity;
+
+            _heads[backward] = edge.from;
+            _reverse[backward] = forward;
+            _residual[backward] = 0;
+        }
+        _built = true;
+    }
+
+    void activate(size_t v) {
+        _active[ _labels[v] ].push_back(v);
+        _highest = std::max(_highest, _labels[v]);
+    }
+
+    // Reverse BFS from the sink, vertices that can't reach it get n + distance to the source
+    void global_relabel(size_t start, size_t finish) {
+        const auto unreached = 2 * _size;
+        _labels.assign(_size, unreached);
+
+        std::queue<size_t> queue;
+        auto bfs = [&](size_t root, size_t label) {
+            _labels[root] = label;
+            queue.push(root);
+
+            while(!queue.empty()) {
+                const auto to = queue.front();
+                queue.pop();
+
+                for(auto arc = _offsets[to]; arc < _offsets[to + 1]; ++arc) {
+                    const auto from = _heads[arc];
+                    if(_labels[from] != unreached || _residual[ _reverse[arc] ] == 0) continue;
+
+                    _labels[from] = _labels[to] + 1;
+                    queue.push(from);
+                }
+            }
+        };
+        _labels[start] = _size;
+        bfs(finish, 0);
+        bfs(start, _size);
+
+        _count.assign(_size, 0);
+        for(auto& bucket : _active) bucket.clear();
+        _highest = 0;
+
+        for(size_t v = 0; v < _size; ++v) {
+            _current[v] = _offsets[v];
+            if(_labels[v] < _size) ++_count[ _labels[v] ];
+            if(_excess[v] > 0 && v != start && v != finish) activate(v);
+        }
+        _work = 0;
+    }
+
+    void gap(size_t label) {
+        for(size_t v = 0; v < _size; ++v) {
+            if(_labels[v] <= label || _labels[v] >= _size) continue;
+
+            --_count[ _labels[v] ];
+            _labels[v] = _size + 1;
+            _current[v] = _offsets[v];
+            if(_excess[v] > 0) activate(v);
+        }
+    }
+
+    void relabel(size_t v) {
+        const auto old_label = _labels[v];
+
+        auto label = 2 * _size;
+        for(auto arc = _offsets[v]; arc < _offsets[v + 1]; ++arc) {
+            if(_residual[arc] > 0) label = std::min(label, _labels[ _heads[arc] ] + 1);
+        }
+        _work += 12 + _offsets[v + 1] - _offsets[v];
+
+        _labels[v] = label;
+        _current[v] = _offsets[v];
+
+        if(old_label < _size) --_count[old_label];
+        if(label < _size) ++_count[label];
+
+        if(old_label < _size && _count[old_label] == 0) {
+            gap(old_label);
+        }
+    }
+
+    void discharge(size_t v, size_t start, size_t finish) {
+        while(_excess[v] > 0) {
+            auto& arc = _current[v];
+            if(arc == _offsets[v + 1]) {
+                relabel(v);
+                if(_labels[v] >= 2 * _size) break;
+                continue;
+            }
+
+            const auto to = _heads[arc];
+            if(_residual[arc] > 0 && _labels[v] == _labels[to] + 1) {
+                const auto flow = static_cast<int>(std::min<long long>(_excess[v], _residual[arc]));
+
+                _residual[arc] -= flow;
+                _residual[ _reverse[arc] ] += flow;
+                _excess[v] -= flow;
+                ++_pushes;
+
+                if(_excess[to] == 0 && to != start && to != finish) activate(to);
+                _excess[to] += flow;
+            } else {
+                ++arc;
+            }
+        }
+    }
+
+public:
+    explicit Graph(size_t size) : _size(size) {}
+
+    // Adding edges after a solve rebuilds the residual graph from scratch.
+    void add_edge(size_t from, size_t to, int capacity) {
+        _edges.push_back({ from, to, capacity });
+        _built = false;
+    }
+
+    size_t max_flow(size_t from, size_t to) {
+        if(!_built) build();
+
+        _excess.assign(_size, 0);
+        _current.resize(_size);
+        _active.assign(2 * _size + 1, {});
+
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            const auto flow = _residual[arc];
+            _residual[arc] = 0;
+            _residual[ _reverse[arc] ] += flow;
+            _excess[ _heads[arc] ] += flow;
+            _excess[from] -= flow;
+        }
+
+        global_relabel(from, to);
+
+        const auto global_relabel_threshold = 6 * _size + _offsets[_size] / 2;
+        while(true) {
+            while(_active[_highest].empty() && _highest > 0) --_highest;
+            if(_active[_highest].empty()) break;
+
+            const auto v = _active[_highest].back();
+            _active[_highest].pop_back();
+            if(_labels[v] != _highest || _excess[v] == 0) continue;
+
+            discharge(v, from, to);
+
+            if(_work > global_relabel_threshold) global_relabel(from, to);
+        }
+
+        return _excess[to];
+    }
+
+    // Residual capacity from -> to, summed over parallel and reverse arcs as in the matrix graphs
+    int get_capacity(size_t from, size_t to) {
+        if(!_built) build();
+
+        int capacity = 0;
+        for(auto arc = _offsets[from]; arc < _offsets[from + 1]; ++arc) {
+            if(_heads[arc] == to) capacity += _residual[arc];
+        }
+        return capacity;
+    }
+
+    size_t pushes() const {
+        return _pushes;
+    }
+};
+
+
+#ifndef MAX_FLOW_BENCHMARK
+int main() {
+    std::vector<std::vector<size_t>> edges = {
+        { 0, 1, 6 },
+        { 0, 2, 14 },
+        { 1, 2, 1 },
+        { 1, 3, 5 },
+        { 2, 3, 7 },
+        { 2, 4, 10 },
+        { 3, 4, 1 },
+        { 3, 5, 11 },
+        { 4, 5, 12 }
+    };
+
+    Graph graph(6);
+    for(const auto& edge : edges) {
+        graph.add_edge(edge[0], edge[1], edge[2]);
+    }
+
+    std::cout << "Max flow: " << graph.max_flow(0, 5) << std::endl << std::endl;
+
+    for(const auto& edge : edges) {
+        std::cout << "Flow from " << edge[0] << " to " << edge[1] << ": " << edge[2] - graph.get_capacity(edge[0], edge[1]) << std::endl;
+    }
+
+    return 0;
+}
+#endif